@@ -25,6 +25,12 @@
 #include <boost/asio/local/stream_protocol.hpp>
 #include <boost/asio/read.hpp>
 #include <boost/asio/write.hpp>
+#include <algorithm>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+
+#include "serialization.h"
 
 template <typename B>
 using OutputAdapter = bitsery::OutputBufferAdapter<B>;
@@ -32,6 +38,44 @@ using OutputAdapter = bitsery::OutputBufferAdapter<B>;
 template <typename B>
 using InputAdapter = bitsery::InputBufferAdapter<B>;
 
+/**
+ * Serialized objects that don't fit in this many bytes will cause the thread
+ * local scratch buffers used by `write_object()` and `read_object()` to be
+ * freed again after the object has been sent or received. Most events are only
+ * a few dozen bytes large, but things like preset chunks can easily be several
+ * megabytes, and we don't want every thread that has ever handled a chunk to
+ * hold on to that memory.
+ */
+constexpr size_t max_retained_scratch_buffer_size = 1 << 16;
+
+/**
+ * Get a thread local scratch buffer for use with `write_object()` and
+ * `read_object()` when the caller did not pass a buffer of its own. Every
+ * socket is only ever written to and read from by a single thread at a time
+ * (since those operations are guarded by mutexes or only ever happen on a
+ * dedicated thread), and these functions never call into each other, so the
+ * buffer is never in use twice at the same time. This way the dispatch and
+ * parameter paths will only have to allocate when a message is larger than
+ * any message sent before it on the same thread.
+ */
+inline std::vector<uint8_t>& scratch_buffer() {
+    thread_local std::vector<uint8_t> buffer(64);
+
+    return buffer;
+}
+
+/**
+ * Release the memory held by the thread local scratch buffer if a large object
+ * was just sent or received with it. See `max_retained_scratch_buffer_size`.
+ */
+inline void trim_scratch_buffer() {
+    std::vector<uint8_t>& buffer = scratch_buffer();
+    if (BOOST_UNLIKELY(buffer.capacity() > max_retained_scratch_buffer_size)) {
+        buffer.resize(64);
+        buffer.shrink_to_fit();
+    }
+}
+
 /**
  * Serialize an object using bitsery and write it to a socket. This will write
  * both the size of the serialized object and the object itself over the socket.
@@ -39,7 +83,9 @@ using InputAdapter = bitsery::InputBufferAdapter<B>;
  * @param socket The Boost.Asio socket to write to.
  * @param object The object to write to the stream.
  * @param buffer The buffer to write to. This is useful for sending audio and
- *   chunk data since that can vary in size by a lot.
+ *   chunk data since that can vary in size by a lot. The buffer will be
+ *   resized when needed and is kept around between calls, so reusing the same
+ *   buffer for a socket avoids allocations in the steady state.
  *
  * @warning This operation is not atomic, and calling this function with the
  *   same socket from multiple threads at once will cause issues with the
@@ -48,10 +94,9 @@ using InputAdapter = bitsery::InputBufferAdapter<B>;
  * @relates read_object
  */
 template <typename T, typename Socket>
-inline void write_object(
-    Socket& socket,
-    const T& object,
-    std::vector<uint8_t> buffer = std::vector<uint8_t>(64)) {
+inline void write_object(Socket& socket,
+                         const T& object,
+                         std::vector<uint8_t>& buffer) {
     const size_t size =
         bitsery::quickSerialization<OutputAdapter<std::vector<uint8_t>>>(
             buffer, object);
@@ -70,13 +115,26 @@ inline void write_object(
     assert(bytes_written == size);
 }
 
+/**
+ * The same as the above, but using a thread local scratch buffer instead.
+ *
+ * @see scratch_buffer
+ */
+template <typename T, typename Socket>
+inline void write_object(Socket& socket, const T& object) {
+    write_object(socket, object, scratch_buffer());
+    trim_scratch_buffer();
+}
+
 /**
  * Deserialize an object by reading it from a socket. This should be used
  * together with `write_object`. This will block until the object is available.
  *
  * @param socket The Boost.Asio socket to read from.
  * @param buffer The buffer to read into. This is useful for sending audio and
- *   chunk data since that can vary in size by a lot.
+ *   chunk data since that can vary in size by a lot. Just like with
+ *   `write_object()`, reusing the same buffer avoids allocations in the steady
+ *   state.
  *
  * @return The deserialized object.
  *
@@ -85,8 +143,7 @@ inline void write_object(
  * @relates write_object
  */
 template <typename T, typename Socket>
-inline T read_object(Socket& socket,
-                     std::vector<uint8_t> buffer = std::vector<uint8_t>(64)) {
+inline T read_object(Socket& socket, std::vector<uint8_t>& buffer) {
     // See the note above on the use of `uint64_t` instead of `size_t`
     std::array<uint64_t, 1> message_length;
     boost::asio::read(socket, boost::asio::buffer(message_length));
@@ -114,3 +171,277 @@ inline T read_object(Socket& socket,
 
     return object;
 }
+
+/**
+ * The same as the above, but using a thread local scratch buffer instead.
+ *
+ * @see scratch_buffer
+ */
+template <typename T, typename Socket>
+inline T read_object(Socket& socket) {
+    T object = read_object<T>(socket, scratch_buffer());
+    trim_scratch_buffer();
+
+    return object;
+}
+
+/**
+ * The maximum number of bytes of chunk data we'll pass to a single
+ * `boost::asio::write()` or `boost::asio::read()` call in
+ * `write_chunk_stream()` and `read_chunk_stream()`. The data is sent straight
+ * from and received straight into its final location, so this does not
+ * influence how much memory gets used. It only keeps the individual socket
+ * operations bounded so a multi-megabyte chunk doesn't block a single system
+ * call for the entire transfer.
+ */
+constexpr size_t chunk_stream_piece_size = 1 << 20;
+
+/**
+ * The largest chunk we'll send or receive. Even very large sample based plugins
+ * store references to their samples in their presets rather than the samples
+ * themselves, so anything larger than this means that something went wrong.
+ * The sending side refuses chunks larger than this before sending the event so
+ * the two sides never get out of sync, and `read_chunk_stream()` checks it
+ * again so we won't ever try to allocate an arbitrary amount of memory based on
+ * a size read from a socket.
+ */
+constexpr uint64_t max_chunk_size = 1ull << 30;
+
+// The chunk size is sent as a 64-bit integer, and checking it against this
+// limit also makes sure that it fits in the 32-bit Wine host's `size_t`
+static_assert(max_chunk_size <= SIZE_MAX);
+
+/**
+ * Write the data for a `ChunkStream` to a socket in pieces of at most
+ * `chunk_stream_piece_size` bytes. This should be called right after writing
+ * the `Event` or `EventResult` containing the `ChunkStream` object with
+ * `write_object()`, and `chunk.data()` should point to `chunk.size` bytes of
+ * chunk data.
+ *
+ * @param socket The Boost.Asio socket to write to.
+ * @param chunk The chunk to send.
+ *
+ * @relates read_chunk_stream
+ */
+template <typename Socket>
+inline void write_chunk_stream(Socket& socket, const ChunkStream& chunk) {
+    for (size_t offset = 0; offset < chunk.size;
+         offset += chunk_stream_piece_size) {
+        const size_t piece_size =
+            std::min(chunk_stream_piece_size,
+                     static_cast<size_t>(chunk.size - offset));
+        boost::asio::write(
+            socket, boost::asio::buffer(chunk.data() + offset, piece_size));
+    }
+}
+
+/**
+ * Read the data for a `ChunkStream` that was just received with
+ * `read_object()` into `chunk.buffer`. This is the only place where the
+ * receiving side allocates memory for the chunk.
+ *
+ * @param socket The Boost.Asio socket to read from.
+ * @param chunk The chunk object that was received.
+ *
+ * @throw std::runtime_error If the chunk is larger than `max_chunk_size`. This
+ *   can only happen if the other side didn't check the chunk's size before
+ *   sending it, at which point we can't recover from this anymore.
+ *
+ * @relates write_chunk_stream
+ */
+template <typename Socket>
+inline void read_chunk_stream(Socket& socket, ChunkStream& chunk) {
+    if (chunk.size > max_chunk_size) {
+        throw std::runtime_error(
+            "Refusing to receive a " + std::to_string(chunk.size) +
+            " byte chunk, the maximum chunk size is " +
+            std::to_string(max_chunk_size) + " bytes");
+    }
+
+    chunk.buffer.resize(static_cast<size_t>(chunk.size));
+    for (size_t offset = 0; offset < chunk.size;
+         offset += chunk_stream_piece_size) {
+        const size_t piece_size =
+            std::min(chunk_stream_piece_size,
+                     static_cast<size_t>(chunk.size - offset));
+        boost::asio::read(
+            socket, boost::asio::buffer(chunk.buffer.data() + offset,
+                                        piece_size));
+    }
+}
+
+/**
+ * The fixed size header sent in front of the audio buffers passed to and
+ * returned from `process()`, `processReplacing()` and
+ * `processDoubleReplacing()`. The audio itself is not serialized. Instead, the
+ * samples for every channel directly follow this header on the socket, one
+ * channel after the other. This way we can use scatter-gather I/O to send the
+ * host's buffers and to receive into the plugin's buffers without having to
+ * copy the samples anywhere, since the kernel does all of the copying for us.
+ *
+ * All fields are fixed width so the layout is the same for the 32-bit
+ * bitbridge.
+ */
+struct AudioBufferHeader {
+    /**
+     * The number of samples in every channel.
+     */
+    uint32_t sample_frames;
+    /**
+     * The number of channels following this header.
+     */
+    uint32_t num_channels;
+    /**
+     * Whether the samples are single precision floats (0) or double precision
+     * doubles (1).
+     */
+    uint32_t double_precision;
+};
+
+static_assert(sizeof(AudioBufferHeader) == 12);
+
+/**
+ * The size in bytes of a single channel of the largest audio buffer we'll
+ * accept. Excess channels received by `read_audio_buffers()` get discarded into
+ * a buffer of this size.
+ */
+constexpr size_t max_audio_channel_size = max_buffer_size * sizeof(double);
+
+/**
+ * Write audio buffers to a socket, prefixed by an `AudioBufferHeader`. The
+ * samples are sent directly from `channels` using a single gathering write.
+ *
+ * @param socket The Boost.Asio socket to write to.
+ * @param channels An array of `num_channels` pointers to `sample_frames`
+ *   samples each.
+ * @param num_channels The number of channels in `channels`.
+ * @param sample_frames The number of samples in every channel.
+ * @param buffers A scratch vector for the buffer sequence passed to
+ *   `boost::asio::write()`. Reusing this between calls avoids allocations on
+ *   the audio thread.
+ *
+ * @relates read_audio_buffer_header
+ * @relates read_audio_buffers
+ */
+template <typename T, typename Socket>
+inline void write_audio_buffers(
+    Socket& socket,
+    T* const* channels,
+    uint32_t num_channels,
+    uint32_t sample_frames,
+    std::vector<boost::asio::const_buffer>& buffers) {
+    static_assert(std::is_same_v<T, float> || std::is_same_v<T, double>);
+
+    const AudioBufferHeader header{
+        .sample_frames = sample_frames,
+        .num_channels = num_channels,
+        .double_precision = std::is_same_v<T, double>};
+
+    buffers.clear();
+    buffers.push_back(boost::asio::buffer(&header, sizeof(header)));
+    for (uint32_t channel = 0; channel < num_channels; channel++) {
+        buffers.push_back(
+            boost::asio::buffer(channels[channel], sample_frames * sizeof(T)));
+    }
+
+    boost::asio::write(socket, buffers);
+}
+
+/**
+ * Read the header of a set of audio buffers written with
+ * `write_audio_buffers()`. This should be followed by a call to
+ * `read_audio_buffers()` to read the actual samples.
+ *
+ * @param socket The Boost.Asio socket to read from.
+ *
+ * @return The header describing the audio buffers that follow.
+ *
+ * @throw std::runtime_error If the header contains values that are out of
+ *   bounds.
+ *
+ * @relates write_audio_buffers
+ */
+template <typename Socket>
+inline AudioBufferHeader read_audio_buffer_header(Socket& socket) {
+    AudioBufferHeader header;
+    boost::asio::read(socket, boost::asio::buffer(&header, sizeof(header)));
+
+    if (BOOST_UNLIKELY(header.sample_frames > max_buffer_size ||
+                       header.num_channels > max_audio_channels)) {
+        throw std::runtime_error(
+            "Received an audio buffer with " +
+            std::to_string(header.num_channels) + " channels and " +
+            std::to_string(header.sample_frames) + " samples");
+    }
+
+    return header;
+}
+
+/**
+ * Read the samples following an `AudioBufferHeader` directly into `channels`
+ * using a single scattering read. If the other side sent more channels than
+ * we have room for, then the excess channels are discarded. If it sent fewer
+ * channels, then the remaining channels are filled with silence. This can
+ * happen for a single buffer when a plugin changes its number of outputs,
+ * since the native plugin will only learn about this after the fact.
+ *
+ * @param socket The Boost.Asio socket to read from.
+ * @param header The header returned by `read_audio_buffer_header()`.
+ * @param channels An array of `num_channels` pointers to buffers that can hold
+ *   at least `header.sample_frames` samples each.
+ * @param num_channels The number of channels in `channels`.
+ * @param buffers A scratch vector for the buffer sequence passed to
+ *   `boost::asio::read()`.
+ * @param discarded_samples The buffer excess channels get read into. This
+ *   should be allocated with `max_audio_channel_size` bytes ahead of time so
+ *   we never have to allocate memory on the audio thread.
+ *
+ * @throw std::runtime_error If the samples in the buffer are of a different
+ *   type than `T`.
+ *
+ * @relates write_audio_buffers
+ */
+template <typename T, typename Socket>
+inline void read_audio_buffers(
+    Socket& socket,
+    const AudioBufferHeader& header,
+    T* const* channels,
+    uint32_t num_channels,
+    std::vector<boost::asio::mutable_buffer>& buffers,
+    std::vector<uint8_t>& discarded_samples) {
+    static_assert(std::is_same_v<T, float> || std::is_same_v<T, double>);
+
+    constexpr bool is_double_precision = std::is_same_v<T, double>;
+    if (BOOST_UNLIKELY(static_cast<bool>(header.double_precision) !=
+                       is_double_precision)) {
+        throw std::runtime_error(
+            "Received audio buffers with the wrong sample type");
+    }
+
+    const size_t channel_size = header.sample_frames * sizeof(T);
+    buffers.clear();
+    for (uint32_t channel = 0; channel < header.num_channels; channel++) {
+        if (BOOST_LIKELY(channel < num_channels)) {
+            buffers.push_back(
+                boost::asio::buffer(channels[channel], channel_size));
+        } else {
+            // Any excess channels all get read into the same buffer. This
+            // resize is only a fallback for when the caller did not allocate
+            // that buffer ahead of time.
+            if (BOOST_UNLIKELY(discarded_samples.size() < channel_size)) {
+                discarded_samples.resize(channel_size);
+            }
+
+            buffers.push_back(
+                boost::asio::buffer(discarded_samples.data(), channel_size));
+        }
+    }
+
+    boost::asio::read(socket, buffers);
+
+    for (uint32_t channel = header.num_channels; channel < num_channels;
+         channel++) {
+        std::fill(channels[channel], channels[channel] + header.sample_frames,
+                  0.0);
+    }
+}
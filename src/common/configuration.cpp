@@ -81,6 +81,22 @@ Configuration::Configuration(const fs::path& config_path,
         hack_reaper_update_display =
             table["hack_reaper_update_display"].value<bool>().value_or(false);
         group = table["group"].value<std::string>();
+        group_shell_plugins =
+            table["group_shell_plugins"].value<bool>().value_or(true);
+        if (const auto linger = table["group_linger"].value<int64_t>()) {
+            group_linger = static_cast<uint32_t>(std::max<int64_t>(0, *linger));
+        } else if (table["group_linger"].value<std::string>() == "forever") {
+            group_linger = std::nullopt;
+        } else if (table.contains("group_linger")) {
+            invalid_options.push_back("group_linger");
+        }
+        if (const toml::array* patterns = table["readahead"].as_array()) {
+            for (const toml::node& pattern : *patterns) {
+                if (const auto pattern_string = pattern.value<std::string>()) {
+                    readahead_files.push_back(*pattern_string);
+                }
+            }
+        }
 
         break;
     }
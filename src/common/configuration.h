@@ -22,7 +22,11 @@
 #include <boost/filesystem.hpp>
 
 #include <bitsery/ext/std_optional.h>
+#include <bitsery/traits/string.h>
+#include <bitsery/traits/vector.h>
 #include <optional>
+#include <string>
+#include <vector>
 
 #include "bitsery/ext/boost-path.h"
 
@@ -89,9 +93,12 @@ class Configuration {
 
     /**
      * If this is set to true, then any calls to `audioMasterUpdateDisplay()`
-     * will automatically return 0 without being sent to the host. This is a
-     * HACK to work around implementations issues in REAPER and Renoise, see #29
-     * and #32.
+     * will return 0 immediately and they will be sent to the host
+     * asynchronously from the thread that handles deferred host callbacks,
+     * instead of only those made from the GUI thread. This way the host can't
+     * call back into the plugin while the plugin is waiting for the host. This
+     * is a HACK to work around implementations issues in REAPER and Renoise,
+     * see #29 and #32.
      */
     bool hack_reaper_update_display = false;
 
@@ -102,6 +109,47 @@ class Configuration {
      */
     std::optional<std::string> group;
 
+    /**
+     * If this is set to true and `group` has not been set, then shell plugins
+     * such as WaveShell will be hosted in a plugin group named
+     * `shell-<dll_name>` so the shell's `.dll` file only has to be loaded
+     * once. We only know that a plugin is a shell plugin after the host has
+     * enumerated its sub-plugins at least once, see
+     * `../plugin/shell-plugin-cache.h`.
+     */
+    bool group_shell_plugins = true;
+
+    /**
+     * How many seconds a group host process should keep running after its last
+     * plugin has exited. This makes plugin scanning much faster, since the
+     * group host process doesn't have to be restarted for every plugin. When
+     * this is a nullopt, set using `group_linger = "forever"`, the group host
+     * process will never shut down on its own. The group host process will use
+     * the longest value of all plugins it has hosted, with `"forever"` taking
+     * precedence over everything else.
+     */
+    std::optional<uint32_t> group_linger = 2;
+
+    /**
+     * Glob patterns for additional files, relative to the plugin's `.dll` file,
+     * that should be read into the page cache while the Wine process is
+     * starting. The `.dll` file itself is always read ahead. This is useful for
+     * large plugins that load resource files from next to their `.dll` file
+     * right after being initialized.
+     *
+     * @see ../plugin/utils.h:readahead_plugin_files
+     */
+    std::vector<std::string> readahead_files;
+
+    /**
+     * The names of the options in the matched section whose values had the
+     * wrong type, for instance a `group_linger` that's neither an integer nor
+     * `"forever"`. These options are left at their default values, and they'll
+     * be listed in the initialization message so they don't get silently
+     * ignored.
+     */
+    std::vector<std::string> invalid_options;
+
     /**
      * The path to the configuration file that was parsed.
      */
@@ -118,6 +166,13 @@ class Configuration {
         s.value1b(hack_reaper_update_display);
         s.ext(group, bitsery::ext::StdOptional(),
               [](S& s, auto& v) { s.text1b(v, 4096); });
+        s.value1b(group_shell_plugins);
+        s.ext(group_linger, bitsery::ext::StdOptional(),
+              [](S& s, auto& v) { s.value4b(v); });
+        s.container(readahead_files, 4096,
+                    [](S& s, auto& v) { s.text1b(v, 4096); });
+        s.container(invalid_options, 64,
+                    [](S& s, auto& v) { s.text1b(v, 4096); });
         s.ext(matched_file, bitsery::ext::StdOptional(),
               [](S& s, auto& v) { s.ext(v, bitsery::ext::BoostPath()); });
         s.ext(matched_pattern, bitsery::ext::StdOptional(),
@@ -17,9 +17,11 @@
 #pragma once
 
 #include <mutex>
+#include <sstream>
 
 #include "communication.h"
 #include "logging.h"
+#include "utils.h"
 
 /**
  * Encodes the base behavior for reading from and writing to the `data` argument
@@ -67,11 +69,13 @@ class DefaultDataConverter {
     }
 
     /**
-     * Write the reponse back to the `data` pointer.
+     * Write the reponse back to the `data` pointer. Payloads that are only
+     * used here, such as chunk data, can be moved out of the response instead
+     * of being copied.
      */
     virtual void write(const int /*opcode*/,
                        void* data,
-                       const EventResult& response) const {
+                       EventResult& response) const {
         // The default behavior is to handle this as a null terminated C-style
         // string
         std::visit(overload{[&](const auto&) {},
@@ -175,7 +179,14 @@ intptr_t send_event(boost::asio::local::stream_protocol::socket& socket,
     {
         std::lock_guard lock(write_mutex);
         write_object(socket, event);
+        if (const auto chunk = std::get_if<ChunkStream>(&event.payload)) {
+            write_chunk_stream(socket, *chunk);
+        }
+
         response = read_object<EventResult>(socket);
+        if (auto chunk = std::get_if<ChunkStream>(&response.payload)) {
+            read_chunk_stream(socket, *chunk);
+        }
     }
 
     if (logging) {
@@ -204,6 +215,12 @@ intptr_t send_event(boost::asio::local::stream_protocol::socket& socket,
  *   for sending `dispatch()` events or host callbacks. Optional since it
  *   doesn't have to be done on both sides.
  * @param callback The function used to generate a response out of an event.
+ * @param chunk_logger If set, log how much chunk data was transferred while
+ *   handling `effGetChunk()` and `effSetChunk()` together with the process'
+ *   peak memory usage during that event. This is used in the Wine host so we
+ *   can see how much of the (32-bit) address space loading and saving presets
+ *   requires. This is only done when that logger's verbosity level is set to
+ *   at least `Logger::Verbosity::most_events`.
  *
  * @tparam F A function type in the form of `EventResponse(Event)`.
  *
@@ -213,8 +230,27 @@ intptr_t send_event(boost::asio::local::stream_protocol::socket& socket,
 template <typename F>
 void receive_event(boost::asio::local::stream_protocol::socket& socket,
                    std::optional<std::pair<Logger&, bool>> logging,
-                   F callback) {
+                   F callback,
+                   Logger* chunk_logger = nullptr) {
     auto event = read_object<Event>(socket);
+
+    // The chunk data for `effSetChunk()` is sent separately after the event
+    // itself. `effGetChunk()` gets a `WantsChunkBuffer` instead.
+    auto received_chunk = std::get_if<ChunkStream>(&event.payload);
+    const bool is_chunk_event =
+        received_chunk ||
+        std::holds_alternative<WantsChunkBuffer>(event.payload);
+    // Resetting and reading the peak memory usage requires a couple of system
+    // calls, so we'll only do this when the message will actually be shown
+    const bool log_chunk =
+        chunk_logger && is_chunk_event && chunk_logger->is_verbose();
+    if (log_chunk) {
+        reset_peak_memory_usage();
+    }
+    if (received_chunk) {
+        read_chunk_stream(socket, *received_chunk);
+    }
+
     if (logging) {
         auto [logger, is_dispatch] = *logging;
         logger.log_event(is_dispatch, event.opcode, event.index, event.value,
@@ -230,6 +266,28 @@ void receive_event(boost::asio::local::stream_protocol::socket& socket,
     }
 
     write_object(socket, response);
+    const auto sent_chunk = std::get_if<ChunkStream>(&response.payload);
+    if (sent_chunk) {
+        write_chunk_stream(socket, *sent_chunk);
+    }
+
+    if (log_chunk) {
+        std::ostringstream message;
+        if (received_chunk) {
+            message << "[chunk] Received a " << received_chunk->size
+                    << " byte chunk, " << received_chunk->buffer.size()
+                    << " bytes buffered";
+        } else {
+            message << "[chunk] Sent a "
+                    << (sent_chunk ? sent_chunk->size : 0)
+                    << " byte chunk, 0 bytes buffered";
+        }
+        if (const auto peak_memory_usage = get_peak_memory_usage()) {
+            message << ", peak memory usage "
+                    << *peak_memory_usage / (1024 * 1024) << " MiB";
+        }
+        chunk_logger->log_verbose(message.str());
+    }
 }
 
 /**
@@ -273,8 +331,8 @@ auto passthrough_event(AEffect* plugin, F callback) {
             [&](const std::string& s) -> void* {
                 return const_cast<char*>(s.c_str());
             },
-            [&](const std::vector<uint8_t>& buffer) -> void* {
-                return const_cast<uint8_t*>(buffer.data());
+            [&](const ChunkStream& chunk) -> void* {
+                return const_cast<uint8_t*>(chunk.data());
             },
             [&](native_size_t& window_handle) -> void* {
                 // This is the X11 window handle that the editor should reparent
@@ -319,13 +377,13 @@ auto passthrough_event(AEffect* plugin, F callback) {
                 std::visit(read_payload_fn, *event.value_payload));
         }
 
-        const intptr_t return_value = callback(
-            plugin, event.opcode, event.index, value, data, event.option);
+        intptr_t return_value = callback(plugin, event.opcode, event.index,
+                                         value, data, event.option);
 
         // Only write back data when needed, this depends on the event payload
         // type
         auto write_payload_fn = overload{
-            [&](auto) -> EventResultPayload { return nullptr; },
+            [&](const auto&) -> EventResultPayload { return nullptr; },
             [&](const AEffect& updated_plugin) -> EventResultPayload {
                 // This is a bit of a special case! Instead of writing some
                 // return value, we will update values on the native VST
@@ -341,10 +399,26 @@ auto passthrough_event(AEffect* plugin, F callback) {
                 // In this case the plugin will have written its data stored in
                 // an array to which a pointer is stored in `data`, with the
                 // return value from the event determines how much data the
-                // plugin has written
+                // plugin has written. We don't copy this data, it will be
+                // written to the socket straight from the plugin's buffer in
+                // `receive_event()`.
                 const uint8_t* chunk_data = *static_cast<uint8_t**>(data);
-                return std::vector<uint8_t>(chunk_data,
-                                            chunk_data + return_value);
+                if (!chunk_data || return_value <= 0) {
+                    return ChunkStream{};
+                }
+
+                // The other side would refuse to receive a chunk this large,
+                // so we'll report an empty chunk instead of sending it
+                if (static_cast<uint64_t>(return_value) > max_chunk_size) {
+                    return_value = 0;
+                    return ChunkStream{};
+                }
+
+                ChunkStream chunk;
+                chunk.size = static_cast<uint64_t>(return_value);
+                chunk.source = chunk_data;
+
+                return chunk;
             },
             [&](VstIOProperties& props) -> EventResultPayload { return props; },
             [&](VstMidiKeyName& key_name) -> EventResultPayload {
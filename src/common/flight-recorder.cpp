@@ -0,0 +1,247 @@
+// yabridge: a Wine VST bridge
+// Copyright (C) 2020  Robbert van der Helm
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#include "flight-recorder.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <new>
+#include <stdexcept>
+
+#include "logging.h"
+
+namespace fs = boost::filesystem;
+
+/**
+ * Map a process local ring buffer. Used both for the process local flight
+ * recorders and as a fallback when we can't use shared memory.
+ */
+FlightRecorderRing* map_local_ring() {
+    void* memory =
+        mmap(nullptr, sizeof(FlightRecorderRing), PROT_READ | PROT_WRITE,
+             MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (memory == MAP_FAILED) {
+        throw std::runtime_error("Could not allocate the flight recorder");
+    }
+
+    return new (memory) FlightRecorderRing();
+}
+
+/**
+ * Write a human readable description of a single flight recorder entry to a
+ * stream.
+ */
+void describe_entry(std::ostream& stream, const FlightRecorderEntry& entry) {
+    const auto describe_opcode = [&](bool is_dispatch) {
+        if (const auto opcode_name =
+                opcode_to_string(is_dispatch, entry.opcode)) {
+            stream << *opcode_name;
+        } else {
+            stream << "<opcode = " << entry.opcode << ">";
+        }
+    };
+
+    switch (entry.event) {
+        case FlightRecorderEvent::dispatch:
+        case FlightRecorderEvent::host_callback:
+            stream << (entry.event == FlightRecorderEvent::dispatch
+                           ? "dispatch()      "
+                           : "audioMaster()   ");
+            describe_opcode(entry.event == FlightRecorderEvent::dispatch);
+            stream << "(index = " << entry.index << ", value = " << entry.value
+                   << ", option = " << entry.option << ")";
+            break;
+        case FlightRecorderEvent::dispatch_response:
+        case FlightRecorderEvent::host_callback_response:
+            stream << (entry.event == FlightRecorderEvent::dispatch_response
+                           ? "dispatch()      "
+                           : "audioMaster()   ");
+            describe_opcode(entry.event ==
+                            FlightRecorderEvent::dispatch_response);
+            stream << " -> " << entry.value;
+            break;
+        case FlightRecorderEvent::get_parameter:
+            stream << "getParameter()  index = " << entry.index;
+            break;
+        case FlightRecorderEvent::get_parameter_response:
+            stream << "getParameter()  index = " << entry.index << " -> "
+                   << entry.option;
+            break;
+        case FlightRecorderEvent::set_parameter:
+            stream << "setParameter()  index = " << entry.index
+                   << ", value = " << entry.option;
+            break;
+        case FlightRecorderEvent::set_parameter_response:
+            stream << "setParameter()  index = " << entry.index << " -> done";
+            break;
+        case FlightRecorderEvent::process:
+            stream << "process()       " << entry.index << " samples";
+            break;
+        case FlightRecorderEvent::process_response:
+            stream << "process()       " << entry.index << " samples -> done";
+            break;
+        default:
+            stream << "<unknown event " << static_cast<uint32_t>(entry.event)
+                   << ">";
+            break;
+    }
+}
+
+FlightRecorder::FlightRecorder() : ring(map_local_ring()) {}
+
+FlightRecorder::FlightRecorder(const std::string& shared_memory_name,
+                               bool create)
+    : ring(nullptr) {
+    const int fd = shm_open(shared_memory_name.c_str(),
+                            create ? O_RDWR | O_CREAT | O_EXCL : O_RDWR, 0600);
+    if (fd != -1) {
+        if (!create || ftruncate(fd, sizeof(FlightRecorderRing)) == 0) {
+            void* memory =
+                mmap(nullptr, sizeof(FlightRecorderRing),
+                     PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+            if (memory != MAP_FAILED) {
+                // The side creating the object initializes it, the other side
+                // will just reuse the existing ring
+                ring = create ? new (memory) FlightRecorderRing()
+                              : static_cast<FlightRecorderRing*>(memory);
+            }
+        }
+
+        // The mapping stays valid after closing the file descriptor
+        close(fd);
+        if (create) {
+            owned_shared_memory_name = shared_memory_name;
+        }
+    }
+
+    if (!ring) {
+        unlink();
+        ring = map_local_ring();
+    }
+}
+
+FlightRecorder::~FlightRecorder() {
+    unlink();
+    munmap(ring, sizeof(FlightRecorderRing));
+}
+
+void FlightRecorder::record(FlightRecorderEvent event,
+                            int opcode,
+                            int index,
+                            int64_t value,
+                            float option) noexcept {
+    // `gettid()` is a system call, so we'll only do this once per thread
+    thread_local const uint32_t current_thread_id =
+        static_cast<uint32_t>(syscall(SYS_gettid));
+
+    timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    const uint32_t entry_idx =
+        ring->next_entry.fetch_add(1, std::memory_order_relaxed) %
+        flight_recorder_capacity;
+    ring->entries[entry_idx] = FlightRecorderEntry{
+        .timestamp = static_cast<uint64_t>(now.tv_sec) * 1'000'000'000 +
+                     static_cast<uint64_t>(now.tv_nsec),
+        .thread_id = current_thread_id,
+        .event = event,
+        .opcode = opcode,
+        .index = index,
+        .value = value,
+        .option = option};
+}
+
+std::vector<FlightRecorderEntry> FlightRecorder::snapshot() const {
+    // We'll start at the oldest entry, and we'll skip over any entries that
+    // have not been written to yet
+    const uint32_t first_entry =
+        ring->next_entry.load(std::memory_order_acquire);
+
+    std::vector<FlightRecorderEntry> entries;
+    entries.reserve(flight_recorder_capacity);
+    for (uint32_t i = 0; i < flight_recorder_capacity; i++) {
+        const FlightRecorderEntry& entry =
+            ring->entries[(first_entry + i) % flight_recorder_capacity];
+        if (entry.timestamp != 0) {
+            entries.push_back(entry);
+        }
+    }
+
+    return entries;
+}
+
+void FlightRecorder::unlink() {
+    if (!owned_shared_memory_name.empty()) {
+        shm_unlink(owned_shared_memory_name.c_str());
+        owned_shared_memory_name.clear();
+    }
+}
+
+std::string flight_recorder_name(const fs::path& socket_endpoint) {
+    // The socket's file name is something like
+    // `yabridge-<plugin_name>-<random_id>.sock`, and POSIX shared memory object
+    // names should consist of a leading slash followed by a file name
+    return "/" + socket_endpoint.stem().string();
+}
+
+bool write_flight_recorder_dump(const fs::path& path,
+                                const FlightRecorder& plugin_recorder,
+                                const FlightRecorder& host_recorder) {
+    std::ofstream dump(path.string());
+    if (!dump) {
+        return false;
+    }
+
+    // Tag every entry with the side it originated from, and then merge them
+    // into a single timeline
+    std::vector<std::pair<FlightRecorderEntry, bool>> entries;
+    for (const auto& entry : plugin_recorder.snapshot()) {
+        entries.emplace_back(entry, false);
+    }
+    for (const auto& entry : host_recorder.snapshot()) {
+        entries.emplace_back(entry, true);
+    }
+    std::stable_sort(entries.begin(), entries.end(),
+                     [](const auto& lhs, const auto& rhs) {
+                         return lhs.first.timestamp < rhs.first.timestamp;
+                     });
+
+    dump << "yabridge flight recorder, last " << entries.size() << " events"
+         << std::endl;
+    dump << "Timestamps are relative to the last recorded event." << std::endl;
+    dump << std::endl;
+
+    const uint64_t last_timestamp =
+        entries.empty() ? 0 : entries.back().first.timestamp;
+    for (const auto& [entry, is_wine_host] : entries) {
+        dump << std::fixed << std::setprecision(3) << std::setw(12)
+             << -static_cast<double>(last_timestamp - entry.timestamp) / 1.0e6
+             << " ms  " << (is_wine_host ? "[Wine] " : "[Linux]") << " tid "
+             << std::setw(7) << entry.thread_id << "  ";
+        dump.unsetf(std::ios::floatfield);
+        dump << std::setprecision(6);
+        describe_entry(dump, entry);
+        dump << std::endl;
+    }
+
+    return static_cast<bool>(dump);
+}
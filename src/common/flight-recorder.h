@@ -0,0 +1,201 @@
+// yabridge: a Wine VST bridge
+// Copyright (C) 2020  Robbert van der Helm
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#ifdef __WINE__
+#include "../wine-host/boost-fix.h"
+#endif
+#include <boost/filesystem.hpp>
+
+/**
+ * The number of entries in a flight recorder's ring buffer. This should be a
+ * power of two so the ring index can simply wrap around.
+ */
+constexpr uint32_t flight_recorder_capacity = 4096;
+
+/**
+ * The different kinds of events that get recorded by the flight recorder.
+ */
+enum class FlightRecorderEvent : uint32_t {
+    dispatch = 1,
+    dispatch_response,
+    host_callback,
+    host_callback_response,
+    get_parameter,
+    get_parameter_response,
+    set_parameter,
+    set_parameter_response,
+    process,
+    process_response,
+};
+
+/**
+ * A single entry in the flight recorder. This is a fixed size struct so it can
+ * be written to shared memory without any allocations. The meaning of the
+ * fields depends on the type of event:
+ *
+ * - For `dispatch` and `host_callback` events, all fields correspond to the
+ *   arguments of that function call. For the responses, `value` contains the
+ *   return value.
+ * - For parameter events `index` is the parameter's index and `option` is the
+ *   parameter's value, if there is one.
+ * - For `process` events `index` contains the number of samples being
+ *   processed.
+ *
+ * The struct's layout is identical for the 32-bit and the 64-bit versions of
+ * yabridge, since a 64-bit plugin may need to read the ring written by the
+ * 32-bit bitbridge.
+ */
+struct alignas(8) FlightRecorderEntry {
+    /**
+     * A `CLOCK_MONOTONIC` timestamp in nanoseconds. This clock is shared by
+     * both processes so entries from both sides can be merged into a single
+     * timeline.
+     */
+    uint64_t timestamp;
+    /**
+     * The Linux thread ID of the thread that recorded this event.
+     */
+    uint32_t thread_id;
+    FlightRecorderEvent event;
+    int32_t opcode;
+    int32_t index;
+    int64_t value;
+    float option;
+};
+
+static_assert(sizeof(FlightRecorderEntry) == 40);
+
+/**
+ * The ring buffer backing a flight recorder. This is either stored in shared
+ * memory or in regular process local memory.
+ */
+struct FlightRecorderRing {
+    /**
+     * The total number of entries ever written to this ring. The next entry
+     * will be written at `next_entry % flight_recorder_capacity`. Since the
+     * capacity is a power of two, this will still work correctly after this
+     * integer wraps around.
+     */
+    std::atomic<uint32_t> next_entry;
+    FlightRecorderEntry entries[flight_recorder_capacity];
+};
+
+static_assert(std::atomic<uint32_t>::is_always_lock_free);
+
+/**
+ * An always enabled, low overhead recorder for the last few thousand events
+ * that passed through either side of the bridge. Both the native plugin and
+ * the Wine host have one of these. The Wine host's recorder is stored in a
+ * shared memory object created by the native plugin, so when the Wine host
+ * crashes the native plugin can still write the last events that happened on
+ * both sides to a file. Recording an event only involves an atomic increment
+ * and writing a few integers.
+ *
+ * Writing to the ring is not synchronised beyond that atomic increment, so
+ * when a snapshot is taken while other threads are still writing the last few
+ * entries might be incomplete. This is fine since we only read the ring after
+ * something has already gone wrong.
+ */
+class FlightRecorder {
+   public:
+    /**
+     * Create a flight recorder backed by process local memory.
+     */
+    FlightRecorder();
+
+    /**
+     * Create a flight recorder backed by a POSIX shared memory object.
+     *
+     * @param shared_memory_name The name of the shared memory object, including
+     *   the leading slash. See `flight_recorder_name()`.
+     * @param create Whether to create the shared memory object, or to open an
+     *   existing object. The side that creates the object is also responsible
+     *   for unlinking it again.
+     *
+     * If the shared memory object cannot be created or opened, then we'll
+     * silently fall back to process local memory since not being able to
+     * record events should never prevent a plugin from loading.
+     */
+    FlightRecorder(const std::string& shared_memory_name, bool create);
+
+    ~FlightRecorder();
+
+    FlightRecorder(const FlightRecorder&) = delete;
+    FlightRecorder& operator=(const FlightRecorder&) = delete;
+
+    /**
+     * Record an event. This is safe to call from any thread, including the
+     * audio thread.
+     */
+    void record(FlightRecorderEvent event,
+                int opcode,
+                int index,
+                int64_t value,
+                float option = 0.0) noexcept;
+
+    /**
+     * Copy all recorded entries out of the ring, ordered from oldest to newest.
+     */
+    std::vector<FlightRecorderEntry> snapshot() const;
+
+    /**
+     * Remove the name of the shared memory object, if this recorder created
+     * it. The memory itself stays mapped in both processes. This should be
+     * called once the other side has opened the object so we don't leave
+     * anything behind in `/dev/shm`.
+     */
+    void unlink();
+
+   private:
+    FlightRecorderRing* ring;
+
+    /**
+     * The name of the shared memory object we created, if we created one and
+     * it has not yet been unlinked.
+     */
+    std::string owned_shared_memory_name;
+};
+
+/**
+ * Generate the name of the shared memory object used for the Wine host's
+ * flight recorder. This is derived from the socket endpoint since that is
+ * already unique for every plugin instance and known to both sides.
+ *
+ * @param socket_endpoint The path to the plugin's socket endpoint.
+ */
+std::string flight_recorder_name(
+    const boost::filesystem::path& socket_endpoint);
+
+/**
+ * Merge the entries from the native plugin's and the Wine host's flight
+ * recorders and write them to a file as a single timeline.
+ *
+ * @param path The file to write to.
+ * @param plugin_recorder The flight recorder of the native plugin.
+ * @param host_recorder The flight recorder of the Wine host.
+ *
+ * @return Whether the file could be written.
+ */
+bool write_flight_recorder_dump(const boost::filesystem::path& path,
+                                const FlightRecorder& plugin_recorder,
+                                const FlightRecorder& host_recorder);
@@ -50,20 +50,27 @@ Logger::Logger(std::shared_ptr<std::ostream> stream,
                std::string prefix)
     : stream(stream), verbosity(verbosity_level), prefix(prefix) {}
 
-Logger Logger::create_from_environment(std::string prefix) {
+/**
+ * Parse the verbosity level from the `YABRIDGE_DEBUG_LEVEL` environment
+ * variable. Defaults to `Verbosity::basic` if the environment variable has not
+ * been set or if it is not an integer.
+ */
+static Logger::Verbosity verbosity_from_environment() {
     auto env = boost::this_process::environment();
-    std::string file_path = env[logging_file_environment_variable].to_string();
     std::string verbosity =
         env[logging_verbosity_environment_variable].to_string();
 
-    // Default to `Verbosity::basic` if the environment variable has not
-    // been set or if it is not an integer.
-    Verbosity verbosity_level;
     try {
-        verbosity_level = static_cast<Verbosity>(std::stoi(verbosity));
+        return static_cast<Logger::Verbosity>(std::stoi(verbosity));
     } catch (const std::invalid_argument&) {
-        verbosity_level = Verbosity::basic;
+        return Logger::Verbosity::basic;
     }
+}
+
+Logger Logger::create_from_environment(std::string prefix) {
+    auto env = boost::this_process::environment();
+    std::string file_path = env[logging_file_environment_variable].to_string();
+    const Verbosity verbosity_level = verbosity_from_environment();
 
     // If `file` points to a valid location then use create/truncate the
     // file and write all of the logs there, otherwise use STDERR
@@ -82,6 +89,13 @@ Logger Logger::create_from_environment(std::string prefix) {
     }
 }
 
+Logger Logger::create_for_wine_stderr() {
+    // `std::cerr` has static storage duration, so it should not be deleted
+    // when the last logger referencing it gets destroyed
+    return Logger(std::shared_ptr<std::ostream>(&std::cerr, [](auto*) {}),
+                  verbosity_from_environment());
+}
+
 void Logger::log(const std::string& message) {
     const auto current_time = std::chrono::system_clock::now();
     const std::time_t timestamp =
@@ -105,6 +119,16 @@ void Logger::log(const std::string& message) {
     *stream << formatted_message.str() << std::flush;
 }
 
+void Logger::log_verbose(const std::string& message) {
+    if (BOOST_UNLIKELY(is_verbose())) {
+        log(message);
+    }
+}
+
+bool Logger::is_verbose() const {
+    return verbosity >= Verbosity::most_events;
+}
+
 void Logger::log_get_parameter(int index) {
     if (BOOST_UNLIKELY(verbosity >= Verbosity::most_events)) {
         std::ostringstream message;
@@ -192,8 +216,8 @@ void Logger::log_event(bool is_dispatch,
                         message << "<" << s.size() << " bytes>";
                     }
                 },
-                [&](const std::vector<uint8_t>& buffer) {
-                    message << "<" << buffer.size() << " byte chunk>";
+                [&](const ChunkStream& chunk) {
+                    message << "<" << chunk.size << " byte chunk>";
                 },
                 [&](const native_size_t& window_id) {
                     message << "<window " << window_id << ">";
@@ -271,8 +295,8 @@ void Logger::log_event_response(
                         message << ", <" << s.size() << " bytes>";
                     }
                 },
-                [&](const std::vector<uint8_t>& buffer) {
-                    message << ", <" << buffer.size() << " byte chunk>";
+                [&](const ChunkStream& chunk) {
+                    message << ", <" << chunk.size << " byte chunk>";
                 },
                 [&](const AEffect&) { message << ", <AEffect_object>"; },
                 [&](const DynamicSpeakerArrangement& speaker_arrangement) {
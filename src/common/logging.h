@@ -83,6 +83,15 @@ class Logger {
      */
     static Logger create_from_environment(std::string prefix = "");
 
+    /**
+     * Create a logger that writes to this process's STDERR stream, using the
+     * verbosity level set through the environment. This is meant for the Wine
+     * host. Its STDERR stream is captured and written to the native plugin's
+     * log, or to the group host's log when the plugin is hosted in a group.
+     * Using `create_from_environment()` there would bypass those captures.
+     */
+    static Logger create_for_wine_stderr();
+
     /**
      * Write a message to the log, prefixing it with a timestamp and this
      * logger's prefix string.
@@ -91,6 +100,22 @@ class Logger {
      */
     void log(const std::string& message);
 
+    /**
+     * The same as `log()`, but only when the verbosity level is set to at least
+     * `Verbosity::most_events`. This is used for periodic diagnostic
+     * information that would otherwise clutter up the log.
+     *
+     * @param message The message to write.
+     */
+    void log_verbose(const std::string& message);
+
+    /**
+     * Whether messages passed to `log_verbose()` will actually be written. This
+     * can be used to avoid gathering diagnostic information that would
+     * otherwise be thrown away.
+     */
+    bool is_verbose() const;
+
     // The following functions are for logging specific events, they are only
     // enabled for verbosity levels higher than 1 (i.e. `Verbosity::events`)
     void log_get_parameter(int index);
@@ -53,13 +53,6 @@ constexpr size_t max_midi_events = max_buffer_size / sizeof(size_t);
  */
 [[maybe_unused]] constexpr size_t max_string_length = 64;
 
-/**
- * The size for a buffer in which we're receiving chunks. Allow for up to 50 MB
- * chunks. Hopefully no plugin will come anywhere near this limit, but it will
- * add up when plugins start to audio samples in their presets.
- */
-constexpr size_t binary_buffer_size = 50 << 20;
-
 // The plugin should always be compiled to a 64-bit version, but the host
 // application can also be 32-bit to allow using 32-bit legacy Windows VST in a
 // modern Linux VST host. Because of this we have to make sure to always use
@@ -302,6 +295,53 @@ struct WantsAEffectUpdate {};
  */
 struct WantsChunkBuffer {};
 
+/**
+ * Chunk data passed to `effSetChunk()` or returned from `effGetChunk()`. Only
+ * the chunk's size is serialized. The data itself is written to the socket
+ * directly after the `Event` or `EventResult` containing this object using
+ * `write_chunk_stream()`, and it's read directly into `buffer` on the other
+ * side with `read_chunk_stream()`. Preset chunks can be tens of megabytes
+ * large, and serializing them the regular way would mean that the chunk gets
+ * copied into a vector, then into bitsery's serialization buffer, and on the
+ * receiving side into a deserialization buffer and another vector. In the
+ * 32-bit Wine host that's enough to fragment or exhaust the address space when
+ * a plugin group contains a couple of plugins with large presets. This way the
+ * sending side sends the data straight from the host's or the plugin's own
+ * memory, and the receiving side holds exactly one copy of the chunk.
+ */
+struct ChunkStream {
+    /**
+     * The size of the chunk in bytes. This is always sent as a 64-bit integer
+     * for compatibility with the 32-bit bitbridge.
+     */
+    uint64_t size = 0;
+    /**
+     * On the sending side this points to the host's or the plugin's chunk
+     * data, which should stay valid until the chunk has been written to the
+     * socket. Unused on the receiving side. Not serialized.
+     */
+    const uint8_t* source = nullptr;
+    /**
+     * The buffer the chunk gets read into on the receiving side by
+     * `read_chunk_stream()`. Unused on the sending side. Not serialized.
+     */
+    std::vector<uint8_t> buffer;
+
+    /**
+     * The chunk's data. This is `buffer` on the receiving side and `source` on
+     * the sending side. This is derived from `buffer` every time so it stays
+     * valid when this object gets copied or moved.
+     */
+    const uint8_t* data() const {
+        return buffer.empty() ? source : buffer.data();
+    }
+
+    template <typename S>
+    void serialize(S& s) {
+        s.value8b(size);
+    }
+};
+
 /**
  * Marker struct to indicate that the event handler will write a pointer to a
  * `VstRect` struct into the void pointer. It's also possible that the plugin
@@ -335,10 +375,11 @@ struct WantsString {};
  *         size. We can replace `std::string` with `char*` once it does for
  *         clarity's sake.
  *
- * - A byte vector for handling chunk data during `effSetChunk()`. We can't
+ * - A `ChunkStream` for handling chunk data during `effSetChunk()`. We can't
  *   reuse the regular string handling here since the data may contain null
  *   bytes and `std::string::as_c_str()` might cut off everything after the
- *   first null byte.
+ *   first null byte. The chunk data is sent separately after the event, see
+ *   `ChunkStream` for more information.
  * - An X11 window handle.
  * - Specific data structures from `aeffextx.h`. For instance an event with the
  *   opcode `effProcessEvents` the hosts passes a `VstEvents` struct containing
@@ -359,7 +400,7 @@ struct WantsString {};
  */
 using EventPayload = std::variant<std::nullptr_t,
                                   std::string,
-                                  std::vector<uint8_t>,
+                                  ChunkStream,
                                   native_size_t,
                                   AEffect,
                                   DynamicVstEvents,
@@ -381,9 +422,7 @@ void serialize(S& s, EventPayload& payload) {
               [](S& s, std::string& string) {
                   s.text1b(string, max_string_length);
               },
-              [](S& s, std::vector<uint8_t>& buffer) {
-                  s.container1b(buffer, binary_buffer_size);
-              },
+              [](S& s, ChunkStream& chunk) { s.object(chunk); },
               [](S& s, native_size_t& window_handle) {
                   s.value8b(window_handle);
               },
@@ -447,16 +486,15 @@ struct Event {
  * - Nothing, on which case only the return value from the callback function
  *   gets passed along.
  * - A (short) string.
- * - Some binary blob stored as a byte vector. During `effGetChunk` this will
- *   contain some chunk data that should be written to
- *   `PluginBridge::chunk_data`.
+ * - A `ChunkStream` during `effGetChunk`. The chunk data sent after the
+ *   response should be written to `PluginBridge::chunk_data`.
  * - A specific struct in response to an event such as `audioMasterGetTime` or
  *   `audioMasterIOChanged`.
  * - An X11 window pointer for the editor window.
  */
 using EventResultPayload = std::variant<std::nullptr_t,
                                         std::string,
-                                        std::vector<uint8_t>,
+                                        ChunkStream,
                                         AEffect,
                                         DynamicSpeakerArrangement,
                                         VstIOProperties,
@@ -473,9 +511,7 @@ void serialize(S& s, EventResultPayload& payload) {
               [](S& s, std::string& string) {
                   s.text1b(string, max_string_length);
               },
-              [](S& s, std::vector<uint8_t>& buffer) {
-                  s.container1b(buffer, binary_buffer_size);
-              },
+              [](S& s, ChunkStream& chunk) { s.object(chunk); },
               [](S& s, AEffect& effect) { s.object(effect); },
               [&](DynamicSpeakerArrangement& speaker_arrangement) -> void* {
                   return &speaker_arrangement.as_c_speaker_arrangement();
@@ -549,48 +585,6 @@ struct ParameterResult {
     }
 };
 
-/**
- * A buffer of audio for the plugin to process, or the response of that
- * processing. The number of samples is encoded in each audio buffer's length.
- * This is used for both `process()/processReplacing()` and
- * `processDoubleReplacing()`.
- */
-struct AudioBuffers {
-    /**
-     * An audio buffer for each of the plugin's audio channels. This uses floats
-     * or doubles depending on whether `process()/processReplacing()` or
-     * `processDoubleReplacing()` got called.
-     */
-    std::variant<std::vector<std::vector<float>>,
-                 std::vector<std::vector<double>>>
-        buffers;
-
-    /**
-     * The number of frames in a sample. If buffers is not empty, then
-     * `buffers[0].size() == sample_frames`.
-     */
-    int sample_frames;
-
-    template <typename S>
-    void serialize(S& s) {
-        s.ext(
-            buffers,
-            bitsery::ext::StdVariant{
-                [](S& s, std::vector<std::vector<float>>& buffer) {
-                    s.container(buffer, max_audio_channels, [](S& s, auto& v) {
-                        s.container4b(v, max_buffer_size);
-                    });
-                },
-                [](S& s, std::vector<std::vector<double>>& buffer) {
-                    s.container(buffer, max_audio_channels, [](S& s, auto& v) {
-                        s.container8b(v, max_buffer_size);
-                    });
-                },
-            });
-        s.value4b(sample_frames);
-    }
-};
-
 /**
  * An object containing the startup options for hosting a plugin in a plugin
  * group process. These are the exact same options that would have been passed
@@ -0,0 +1,312 @@
+// yabridge: a Wine VST bridge
+// Copyright (C) 2020  Robbert van der Helm
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#include "thread-monitor.h"
+
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <algorithm>
+#include <condition_variable>
+#include <fstream>
+#include <sstream>
+#include <thread>
+
+using namespace std::literals::chrono_literals;
+
+/**
+ * How often we'll sample the registered threads. Short enough to be able to
+ * correlate the results with xruns, but long enough to not end up spamming the
+ * log.
+ */
+constexpr std::chrono::seconds thread_monitor_interval = 10s;
+
+/**
+ * Get the calling thread's Linux thread ID. `gettid()` is a system call, so
+ * we'll only do this once per thread.
+ */
+static pid_t current_thread_id() {
+    thread_local const pid_t thread_id =
+        static_cast<pid_t>(syscall(SYS_gettid));
+
+    return thread_id;
+}
+
+/**
+ * Find a `<key>: <value>` line in one of the files in `/proc/<pid>/task/<tid>/`
+ * and parse its value as an integer. The `status` file uses tabs and the
+ * `sched` file uses a variable amount of spaces to separate the key and the
+ * value, so we'll just skip over all whitespace after the colon.
+ */
+static std::optional<uint64_t> find_proc_value(std::istream& file,
+                                               const std::string& key) {
+    std::string line;
+    while (std::getline(file, line)) {
+        if (line.starts_with(key)) {
+            const size_t colon_pos = line.find(':', key.size());
+            if (colon_pos == std::string::npos) {
+                return std::nullopt;
+            }
+
+            std::istringstream value(line.substr(colon_pos + 1));
+            uint64_t result;
+            if (value >> result) {
+                return result;
+            } else {
+                return std::nullopt;
+            }
+        }
+    }
+
+    return std::nullopt;
+}
+
+ThreadStats ThreadStats::operator-(const ThreadStats& earlier) const {
+    ThreadStats difference{
+        .voluntary_context_switches =
+            voluntary_context_switches - earlier.voluntary_context_switches,
+        .involuntary_context_switches =
+            involuntary_context_switches - earlier.involuntary_context_switches,
+        .minor_page_faults = minor_page_faults - earlier.minor_page_faults,
+        .major_page_faults = major_page_faults - earlier.major_page_faults,
+        .cpu_migrations = std::nullopt,
+        .cpu_time = cpu_time - earlier.cpu_time};
+    if (cpu_migrations && earlier.cpu_migrations) {
+        difference.cpu_migrations =
+            *cpu_migrations - *earlier.cpu_migrations;
+    }
+
+    return difference;
+}
+
+std::optional<ThreadStats> read_thread_stats(pid_t thread_id) {
+    const std::string task_path =
+        "/proc/self/task/" + std::to_string(thread_id) + "/";
+
+    ThreadStats stats{};
+
+    // The page fault counters and the CPU time can be found in the `stat` file.
+    // The second field is the thread's name in parentheses and that name can
+    // contain spaces, so we'll start parsing after the closing parenthesis.
+    // What follows is the third field of the file.
+    {
+        std::ifstream stat_file(task_path + "stat");
+        std::string stat;
+        if (!std::getline(stat_file, stat)) {
+            return std::nullopt;
+        }
+
+        const size_t name_end_pos = stat.rfind(')');
+        if (name_end_pos == std::string::npos) {
+            return std::nullopt;
+        }
+
+        std::istringstream fields(stat.substr(name_end_pos + 1));
+        std::vector<std::string> values;
+        std::string value;
+        while (fields >> value) {
+            values.push_back(value);
+        }
+
+        // These are the `minflt`, `majflt`, `utime` and `stime` fields as
+        // described in proc(5), offset by the first two fields we skipped
+        if (values.size() < 13) {
+            return std::nullopt;
+        }
+
+        try {
+            stats.minor_page_faults = std::stoull(values[7]);
+            stats.major_page_faults = std::stoull(values[9]);
+
+            const uint64_t clock_ticks =
+                std::stoull(values[11]) + std::stoull(values[12]);
+            stats.cpu_time = std::chrono::microseconds(
+                clock_ticks * 1'000'000 / sysconf(_SC_CLK_TCK));
+        } catch (const std::logic_error&) {
+            return std::nullopt;
+        }
+    }
+
+    {
+        std::ifstream status_file(task_path + "status");
+        const auto voluntary_context_switches =
+            find_proc_value(status_file, "voluntary_ctxt_switches");
+        const auto involuntary_context_switches =
+            find_proc_value(status_file, "nonvoluntary_ctxt_switches");
+        if (!voluntary_context_switches || !involuntary_context_switches) {
+            return std::nullopt;
+        }
+
+        stats.voluntary_context_switches = *voluntary_context_switches;
+        stats.involuntary_context_switches = *involuntary_context_switches;
+    }
+
+    // This file only exists when the kernel has been built with
+    // `CONFIG_SCHED_DEBUG`, so this is optional
+    std::ifstream sched_file(task_path + "sched");
+    stats.cpu_migrations = find_proc_value(sched_file, "se.nr_migrations");
+
+    return stats;
+}
+
+/**
+ * The sampling thread shared by all `ThreadMonitor` instances in this process.
+ * The thread is started when the first monitor gets added. Monitors are only
+ * sampled while holding `monitors_mutex`, so once `remove()` returns the
+ * monitor will not be touched again.
+ */
+class SharedThreadSampler {
+   public:
+    void add(ThreadMonitor& monitor) {
+        std::lock_guard lock(monitors_mutex);
+        monitors.push_back(&monitor);
+        if (!sampler.joinable()) {
+            sampler = std::jthread([&](std::stop_token st) { run(st); });
+        }
+    }
+
+    void remove(ThreadMonitor& monitor) {
+        std::lock_guard lock(monitors_mutex);
+        std::erase(monitors, &monitor);
+    }
+
+   private:
+    /**
+     * Sample all monitors every `thread_monitor_interval` until the stop token
+     * gets triggered.
+     */
+    void run(std::stop_token st) {
+        std::unique_lock lock(monitors_mutex);
+        while (!st.stop_requested()) {
+            // This will return early when the process exits
+            sampler_cv.wait_for(lock, st, thread_monitor_interval,
+                                [] { return false; });
+            if (st.stop_requested()) {
+                break;
+            }
+
+            for (ThreadMonitor* monitor : monitors) {
+                monitor->sample();
+            }
+        }
+    }
+
+    std::vector<ThreadMonitor*> monitors;
+    std::mutex monitors_mutex;
+
+    /**
+     * Used to wake up the sampling thread early when the process exits.
+     * `std::condition_variable_any` can wait on a stop token, and `sampler`
+     * will request a stop when it gets destroyed. This has to be declared
+     * last so the thread gets stopped before the other fields are destroyed.
+     */
+    std::condition_variable_any sampler_cv;
+    std::jthread sampler;
+};
+
+static SharedThreadSampler& shared_sampler() {
+    static SharedThreadSampler sampler;
+
+    return sampler;
+}
+
+ThreadMonitor::ThreadMonitor(Logger& logger) : logger(logger) {
+    shared_sampler().add(*this);
+}
+
+ThreadMonitor::~ThreadMonitor() {
+    shared_sampler().remove(*this);
+}
+
+void ThreadMonitor::register_current_thread(std::string role,
+                                            bool is_audio_thread) {
+    const pid_t thread_id = current_thread_id();
+    const std::optional<ThreadStats> stats = read_thread_stats(thread_id);
+    if (!stats) {
+        return;
+    }
+
+    std::lock_guard lock(threads_mutex);
+    threads.push_back(MonitoredThread{.role = std::move(role),
+                                      .thread_id = thread_id,
+                                      .is_audio_thread = is_audio_thread,
+                                      .is_first_sample = true,
+                                      .last_stats = *stats});
+}
+
+void ThreadMonitor::sample() {
+    // Everything below only gets printed at higher verbosity levels, so
+    // there's no need to read anything from `/proc` otherwise
+    if (!logger.is_verbose()) {
+        return;
+    }
+
+    std::lock_guard lock(threads_mutex);
+
+    // Threads that have exited get removed from the list
+    std::erase_if(threads, [&](MonitoredThread& thread) {
+        const std::optional<ThreadStats> stats =
+            read_thread_stats(thread.thread_id);
+        if (!stats) {
+            return true;
+        }
+
+        const ThreadStats difference = *stats - thread.last_stats;
+        thread.last_stats = *stats;
+
+        std::ostringstream message;
+        message << "[thread stats] " << thread.role << " (tid "
+                << thread.thread_id << "): "
+                << difference.voluntary_context_switches << " voluntary and "
+                << difference.involuntary_context_switches
+                << " involuntary context switches, "
+                << difference.minor_page_faults << " minor and "
+                << difference.major_page_faults << " major page faults";
+        if (difference.cpu_migrations) {
+            message << ", " << *difference.cpu_migrations << " CPU migrations";
+        }
+        message << ", " << difference.cpu_time.count() / 1000
+                << " ms CPU time";
+        logger.log_verbose(message.str());
+
+        // The audio thread should only ever be blocked while waiting for the
+        // next buffer, so these numbers should stay at zero. Page faults on the
+        // audio thread usually mean that the plugin is allocating memory or
+        // loading samples while processing audio, and involuntary context
+        // switches mean that the thread got preempted. Plugins will allocate
+        // their buffers and touch a lot of memory for the first time while
+        // they're being initialized and while processing their first few
+        // buffers, so we'll ignore page faults during the first sample.
+        const bool had_page_faults =
+            !thread.is_first_sample && (difference.minor_page_faults > 0 ||
+                                        difference.major_page_faults > 0);
+        thread.is_first_sample = false;
+        if (thread.is_audio_thread &&
+            (had_page_faults || difference.involuntary_context_switches > 0)) {
+            std::ostringstream warning;
+            warning << "Warning: the audio thread (tid " << thread.thread_id
+                    << ") had "
+                    << difference.minor_page_faults +
+                           difference.major_page_faults
+                    << " page faults and "
+                    << difference.involuntary_context_switches
+                    << " involuntary context switches in the last "
+                    << thread_monitor_interval.count() << " seconds";
+            logger.log_verbose(warning.str());
+        }
+
+        return false;
+    });
+}
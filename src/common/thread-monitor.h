@@ -0,0 +1,141 @@
+// yabridge: a Wine VST bridge
+// Copyright (C) 2020  Robbert van der Helm
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <sys/types.h>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "logging.h"
+
+/**
+ * OS level resource usage counters for a single thread, as reported by the
+ * kernel in `/proc/self/task/<tid>/`. All of these counters only ever go up, so
+ * the interesting information is in the difference between two samples.
+ */
+struct ThreadStats {
+    uint64_t voluntary_context_switches;
+    uint64_t involuntary_context_switches;
+    uint64_t minor_page_faults;
+    uint64_t major_page_faults;
+    /**
+     * The number of times the thread has been moved to another CPU core. This
+     * is only available when the kernel has been compiled with
+     * `CONFIG_SCHED_DEBUG`.
+     */
+    std::optional<uint64_t> cpu_migrations;
+    /**
+     * The amount of CPU time spent in user space and in the kernel.
+     */
+    std::chrono::microseconds cpu_time;
+
+    /**
+     * Get the difference between this sample and an earlier sample of the same
+     * thread.
+     */
+    ThreadStats operator-(const ThreadStats& earlier) const;
+};
+
+/**
+ * Read the current resource usage counters for a thread in this process.
+ *
+ * @param thread_id The thread's Linux thread ID, as returned by `gettid()`.
+ *
+ * @return The thread's counters, or a nullopt if the thread no longer exists.
+ */
+std::optional<ThreadStats> read_thread_stats(pid_t thread_id);
+
+/**
+ * Keeps track of the context switches, page faults and CPU migrations of the
+ * threads that make up one side of a bridge. Threads register themselves with
+ * a role name, and every `thread_monitor_interval` we'll log how much each of
+ * those threads incurred since the last sample when the verbosity level is set
+ * to at least `Logger::Verbosity::most_events`. Audio threads are special since
+ * they should never fault or get preempted while processing audio, so at that
+ * verbosity level we'll also print a warning when that happens. We only
+ * monitor the Wine host's audio thread. On the plugin side the audio thread
+ * belongs to the host and is shared with other plugins, so anything it incurs
+ * can't be attributed to a single plugin.
+ *
+ * All instances in a process share a single sampling thread. This matters for
+ * group hosts, where a single process can contain dozens of bridges.
+ *
+ * We can't use `getrusage(RUSAGE_THREAD)` here since that only works for the
+ * calling thread, and adding system calls to the audio thread is exactly what
+ * we're trying to avoid. Reading the counters from `/proc` on a separate
+ * thread doesn't add any overhead to the threads being monitored.
+ */
+class ThreadMonitor {
+   public:
+    /**
+     * Add this monitor to the process' shared sampling thread, starting that
+     * thread if this is the first monitor in this process. The monitor will
+     * be removed again when this object gets destroyed.
+     *
+     * @param logger The logger to write the statistics and the warnings to.
+     *   This has to outlive this object.
+     */
+    ThreadMonitor(Logger& logger);
+
+    ~ThreadMonitor();
+
+    ThreadMonitor(const ThreadMonitor&) = delete;
+    ThreadMonitor& operator=(const ThreadMonitor&) = delete;
+
+    /**
+     * Start monitoring the calling thread.
+     *
+     * @param role A short human readable description of what this thread does,
+     *   e.g. `parameters`.
+     * @param is_audio_thread Whether this thread processes audio. We'll print a
+     *   warning whenever an audio thread incurs page faults or involuntary
+     *   context switches.
+     */
+    void register_current_thread(std::string role,
+                                 bool is_audio_thread = false);
+
+    /**
+     * Sample all registered threads once and log the results. Threads that
+     * have exited since the last sample are removed. This is called
+     * periodically from the shared sampling thread.
+     */
+    void sample();
+
+   private:
+    struct MonitoredThread {
+        std::string role;
+        pid_t thread_id;
+        bool is_audio_thread;
+        /**
+         * Whether the next sample is the first sample since this thread was
+         * registered. We won't warn about page faults on the audio thread
+         * during that first interval since it overlaps with the plugin's
+         * initialization.
+         */
+        bool is_first_sample;
+        ThreadStats last_stats;
+    };
+
+    Logger& logger;
+
+    std::vector<MonitoredThread> threads;
+    std::mutex threads_mutex;
+};
@@ -17,8 +17,88 @@
 #include "utils.h"
 
 #include <sched.h>
+#include <fstream>
+#include <sstream>
+
+namespace fs = boost::filesystem;
+
+/**
+ * A 64-bit FNV-1a hash. Unlike `std::hash`, this produces the same results for
+ * the native plugin and for the 32-bit group host.
+ */
+uint64_t stable_hash(const std::string& data) {
+    uint64_t hash = 0xcbf29ce484222325;
+    for (const char& byte : data) {
+        hash ^= static_cast<uint8_t>(byte);
+        hash *= 0x100000001b3;
+    }
+
+    return hash;
+}
 
 bool set_realtime_priority() {
     sched_param params{.sched_priority = 5};
     return sched_setscheduler(0, SCHED_FIFO, &params) == 0;
 }
+
+fs::path generate_group_endpoint(const std::string& group_name,
+                                 const fs::path& wine_prefix,
+                                 const PluginArchitecture architecture) {
+    // The plugin uses the prefix it found or the `WINEPREFIX` it was given as
+    // is, while `yabridgectl start-group --prefix` passes a canonicalized path
+    // to the group host. Symlinks and relative paths should result in the same
+    // socket, so we'll hash the canonical path. `~/.wine` and `~/.wine/` are
+    // also the same prefix, so we should treat them the same way. Boost will
+    // append a `/.` to paths that don't exist, so we'll strip that as well.
+    boost::system::error_code error;
+    const fs::path canonical_wine_prefix =
+        fs::weakly_canonical(wine_prefix, error);
+    std::string wine_prefix_string =
+        error ? wine_prefix.string() : canonical_wine_prefix.string();
+    while (wine_prefix_string.size() > 1 &&
+           (wine_prefix_string.back() == '/' ||
+            wine_prefix_string.ends_with("/."))) {
+        wine_prefix_string.pop_back();
+    }
+
+    std::ostringstream socket_name;
+    socket_name << "yabridge-group-" << group_name << "-"
+                << std::to_string(stable_hash(wine_prefix_string)) << "-";
+    switch (architecture) {
+        case PluginArchitecture::vst_32:
+            socket_name << "x32";
+            break;
+        case PluginArchitecture::vst_64:
+            socket_name << "x64";
+            break;
+    }
+    socket_name << ".sock";
+
+    return fs::temp_directory_path() / socket_name.str();
+}
+
+void reset_peak_memory_usage() {
+    // Writing 5 to this file resets the process' peak resident set size, see
+    // proc(5)
+    std::ofstream clear_refs("/proc/self/clear_refs");
+    clear_refs << "5";
+}
+
+std::optional<uint64_t> get_peak_memory_usage() {
+    std::ifstream status_file("/proc/self/status");
+    std::string line;
+    while (std::getline(status_file, line)) {
+        // This is formatted as `VmHWM:\t  123456 kB`
+        if (line.starts_with("VmHWM:")) {
+            std::istringstream value(line.substr(6));
+            uint64_t kilobytes;
+            if (value >> kilobytes) {
+                return kilobytes * 1024;
+            } else {
+                return std::nullopt;
+            }
+        }
+    }
+
+    return std::nullopt;
+}
@@ -16,6 +16,21 @@
 
 #pragma once
 
+#include <cstdint>
+#include <optional>
+#include <string>
+
+#ifdef __WINE__
+#include "../wine-host/boost-fix.h"
+#endif
+#include <boost/filesystem.hpp>
+
+/**
+ * A tag to differentiate between 32 and 64-bit plugins, used to determine which
+ * host application to use.
+ */
+enum class PluginArchitecture { vst_32, vst_64 };
+
 /**
  * Set the scheduling policy to `SCHED_FIFO` with priority 10 for this process.
  * We explicitly don't do this for wineserver itself since from my testing that
@@ -25,3 +40,51 @@
  *   user does not have the privileges to set realtime priorities.
  */
 bool set_realtime_priority();
+
+/**
+ * Generate the group socket endpoint name used based on the name of the group,
+ * the Wine prefix in use and the plugin architecture. The resulting format is
+ * `/tmp/yabridge-group-<group_name>-<wine_prefix_id>-<architecture>.sock`. In
+ * this socket name the `wine_prefix_id` is a numerical hash based on the Wine
+ * prefix in use. This way the same group name can be used for multiple Wine
+ * prefixes and for both 32 and 64 bit plugins without clashes. This is also
+ * used by the group host itself when it gets launched ahead of time with
+ * `--group <name>`, so the hash has to be the same for the 64-bit plugin and
+ * the 32-bit group host. That's why we can't use `std::hash` here.
+ *
+ * @param group_name The name of the plugin group.
+ * @param wine_prefix The name of the Wine prefix in use. This should be
+ *   obtained by first calling `set_wineprefix()` to allow the user to override
+ *   this, and then falling back to `$HOME/.wine` if the environment variable is
+ *   unset. Otherwise plugins run from outwide of a Wine prefix will not be
+ *   groupable with those run from within `~/.wine` even though they both run
+ *   under the same prefix. Symlinks in this path are resolved before it gets
+ *   hashed.
+ * @param architecture The architecture the plugin is using, since 64-bit
+ *   processes can't host 32-bit plugins and the other way around.
+ *
+ * @return A socket endpoint path that corresponds to the format described
+ * above.
+ */
+boost::filesystem::path generate_group_endpoint(
+    const std::string& group_name,
+    const boost::filesystem::path& wine_prefix,
+    const PluginArchitecture architecture);
+
+/**
+ * Reset this process' peak resident set size, so a following call to
+ * `get_peak_memory_usage()` returns the peak memory usage since this point.
+ * This is used to measure how much memory was needed to transfer a chunk.
+ * Failing to reset the peak is not an error, it will only make the result
+ * less useful.
+ */
+void reset_peak_memory_usage();
+
+/**
+ * Get the peak resident set size for this process, either since the process
+ * was started or since the last call to `reset_peak_memory_usage()`.
+ *
+ * @return The peak memory usage in bytes, or a nullopt if this could not be
+ *   read from `/proc/self/status`.
+ */
+std::optional<uint64_t> get_peak_memory_usage();
@@ -96,6 +96,7 @@ const int effFlagsHasEditor = 1;
 const int effFlagsCanReplacing = 1 << 4;   // very likely
 const int effFlagsProgramChunks = 1 << 5;  // from Ardour
 const int effFlagsIsSynth = 1 << 8;        // currently unused
+const int effFlagsCanDoubleReplacing = 1 << 12;
 
 const int effOpen = 0;
 const int effClose = 1;       // currently unused
@@ -164,6 +165,7 @@ const int effStopProcess = 72;
 
 const int kEffectMagic = CCONST('V', 's', 't', 'P');
 const int kVstLangEnglish = 1;
+const int kVstMaxProductStrLen = 64;
 const int kVstMidiType = 1;
 
 const int kVstNanosValid = 1 << 8;
@@ -16,6 +16,8 @@
 
 #include "plugin-bridge.h"
 
+#include <set>
+
 // Generated inside of the build directory
 #include <src/common/config/config.h>
 #include <src/common/config/version.h>
@@ -23,6 +25,7 @@
 #include "../common/communication.h"
 #include "../common/events.h"
 #include "../common/utils.h"
+#include "shell-plugin-cache.h"
 #include "utils.h"
 
 namespace bp = boost::process;
@@ -47,12 +50,19 @@ PluginBridge& get_bridge_instance(const AEffect& plugin) {
 }
 
 PluginBridge::PluginBridge(audioMasterCallback host_callback)
-    : config(load_config_for(get_this_file_location())),
-      vst_plugin_path(find_vst_plugin()),
+    : vst_plugin_path(find_vst_plugin()),
+      cached_shell_plugins(load_cached_shell_plugins(vst_plugin_path)),
+      config(apply_shell_plugin_group(
+          load_config_for(get_this_file_location()),
+          vst_plugin_path,
+          cached_shell_plugins.has_value())),
       // All the fields should be zero initialized because
       // `Vst2PluginInstance::vstAudioMasterCallback` from Bitwig's plugin
       // bridge will crash otherwise
       plugin(),
+      plugin_readahead_handler([&]() {
+          readahead_plugin_files(vst_plugin_path, config.readahead_files);
+      }),
       io_context(),
       socket_endpoint(generate_plugin_endpoint().string()),
       socket_acceptor(io_context, socket_endpoint),
@@ -66,6 +76,10 @@ PluginBridge::PluginBridge(audioMasterCallback host_callback)
       logger(Logger::create_from_environment(
           create_logger_prefix(socket_endpoint.path()))),
       wine_version(get_wine_version()),
+      plugin_flight_recorder(),
+      wine_flight_recorder(flight_recorder_name(socket_endpoint.path()), true),
+      thread_monitor(logger),
+      is_shutting_down(false),
       vst_host(
           config.group
               ? std::unique_ptr<HostProcess>(
@@ -99,6 +113,7 @@ PluginBridge::PluginBridge(audioMasterCallback host_callback)
                 logger.log(
                     "The Wine host process has exited unexpectedly. Check the "
                     "output above for more information.");
+                dump_flight_recorders();
                 std::terminate();
             }
 
@@ -125,6 +140,10 @@ PluginBridge::PluginBridge(audioMasterCallback host_callback)
     socket_acceptor.close();
     fs::remove(socket_endpoint.path());
 
+    // The same goes for the Wine host's flight recorder, which the Wine host
+    // has opened before connecting to our sockets
+    wine_flight_recorder.unlink();
+
     // Set up all pointers for our `AEffect` struct. We will fill this with data
     // from the VST plugin loaded in Wine at the end of this constructor.
     plugin.ptr3 = this;
@@ -139,6 +158,8 @@ PluginBridge::PluginBridge(audioMasterCallback host_callback)
     // instead of asynchronous IO since communication has to be handled in
     // lockstep anyway
     host_callback_handler = std::jthread([&]() {
+        thread_monitor.register_current_thread("host callbacks");
+
         while (true) {
             try {
                 // TODO: Think of a nicer way to structure this and the similar
@@ -146,6 +167,20 @@ PluginBridge::PluginBridge(audioMasterCallback host_callback)
                 receive_event(
                     vst_host_callback, std::pair<Logger&, bool>(logger, false),
                     [&](Event& event) {
+                        plugin_flight_recorder.record(
+                            FlightRecorderEvent::host_callback, event.opcode,
+                            event.index, event.value, event.option);
+
+                        // The plugin tells the host that one or all of its
+                        // parameters have changed, so any cached parameter
+                        // strings are now outdated. `audioMasterAutomate()`
+                        // also tells us the parameter's new value.
+                        if (event.opcode == audioMasterAutomate) {
+                            update_parameter_value(event.index, event.option);
+                        } else if (event.opcode == audioMasterUpdateDisplay) {
+                            invalidate_parameter_strings(std::nullopt);
+                        }
+
                         // MIDI events sent from the plugin back to the host are
                         // a special case here. They have to sent during the
                         // `processReplacing()` function or else the host will
@@ -164,13 +199,27 @@ PluginBridge::PluginBridge(audioMasterCallback host_callback)
 
                             return response;
                         } else {
-                            return passthrough_event(
+                            EventResult response = passthrough_event(
                                 &plugin, host_callback_function)(event);
+                            plugin_flight_recorder.record(
+                                FlightRecorderEvent::host_callback_response,
+                                event.opcode, event.index,
+                                response.return_value);
+
+                            return response;
                         }
                     });
             } catch (const boost::system::system_error&) {
                 // This happens when the sockets got closed because the plugin
-                // is being shut down
+                // is being shut down. If that's not the case, then the Wine
+                // host must have crashed.
+                if (!is_shutting_down) {
+                    logger.log(
+                        "The Wine host process has exited unexpectedly. Check "
+                        "the output above for more information.");
+                    dump_flight_recorders();
+                }
+
                 break;
             }
         }
@@ -227,11 +276,16 @@ class DispatchDataConverter : DefaultDataConverter {
                 return WantsChunkBuffer();
                 break;
             case effSetChunk: {
-                const uint8_t* chunk_data = static_cast<const uint8_t*>(data);
-
                 // When the host passes a chunk it will use the value parameter
-                // to tell us its length
-                return std::vector<uint8_t>(chunk_data, chunk_data + value);
+                // to tell us its length. The data will be sent straight from
+                // the host's buffer after the event, so we don't have to copy
+                // it here. `PluginBridge::dispatch()` has already checked that
+                // this size is valid.
+                ChunkStream chunk;
+                chunk.size = static_cast<uint64_t>(value);
+                chunk.source = static_cast<const uint8_t*>(data);
+
+                return chunk;
             } break;
             case effProcessEvents:
                 return DynamicVstEvents(*static_cast<const VstEvents*>(data));
@@ -300,7 +354,7 @@ class DispatchDataConverter : DefaultDataConverter {
 
     void write(const int opcode,
                void* data,
-               const EventResult& response) const override {
+               EventResult& response) const override {
         switch (opcode) {
             case effOpen: {
                 // Update our `AEffect` object one last time for improperly
@@ -323,12 +377,12 @@ class DispatchDataConverter : DefaultDataConverter {
                 *static_cast<VstRect**>(data) = &rect;
             } break;
             case effGetChunk: {
-                // Write the chunk data to some publically accessible place in
+                // Move the chunk data to some publically accessible place in
                 // `PluginBridge` and write a pointer to that struct to the data
-                // pointer
-                const auto buffer =
-                    std::get<std::vector<uint8_t>>(response.payload);
-                chunk.assign(buffer.begin(), buffer.end());
+                // pointer. The chunk was read straight into this buffer, so
+                // we'll only ever hold a single copy of it.
+                auto& received_chunk = std::get<ChunkStream>(response.payload);
+                chunk = std::move(received_chunk.buffer);
 
                 *static_cast<uint8_t**>(data) = chunk.data();
             } break;
@@ -443,12 +497,17 @@ intptr_t PluginBridge::dispatch(AEffect* /*plugin*/,
 
     DispatchDataConverter converter(chunk_data, plugin, editor_rectangle);
 
+    plugin_flight_recorder.record(FlightRecorderEvent::dispatch, opcode, index,
+                                  value, option);
+
     switch (opcode) {
         case effClose: {
             // Allow the plugin to handle its own shutdown, and then terminate
             // the process. Because terminating the Wine process will also
             // forcefully close all open sockets this will also terminate our
             // handler thread.
+            is_shutting_down = true;
+
             intptr_t return_value = 0;
             try {
                 // TODO: Add some kind of timeout?
@@ -460,6 +519,7 @@ intptr_t PluginBridge::dispatch(AEffect* /*plugin*/,
                 // Thrown when the socket gets closed because the VST plugin
                 // loaded into the Wine process crashed during shutdown
                 logger.log("The plugin crashed during shutdown, ignoring");
+                dump_flight_recorders();
             }
 
             vst_host->terminate();
@@ -478,10 +538,34 @@ intptr_t PluginBridge::dispatch(AEffect* /*plugin*/,
             // thread and socket to pass MIDI events. Otherwise plugins will
             // stop receiving MIDI data when they have an open dropdowns or
             // message box.
-            return send_event(host_vst_dispatch_midi_events,
-                              dispatch_midi_events_mutex, converter,
-                              std::pair<Logger&, bool>(logger, true), opcode,
-                              index, value, data, option);
+            {
+                const intptr_t return_value = send_event(
+                    host_vst_dispatch_midi_events, dispatch_midi_events_mutex,
+                    converter, std::pair<Logger&, bool>(logger, true), opcode,
+                    index, value, data, option);
+                plugin_flight_recorder.record(
+                    FlightRecorderEvent::dispatch_response, opcode, index,
+                    return_value);
+
+                return return_value;
+            }
+            break;
+        case effSetChunk:
+            // The Wine host would refuse to receive a chunk with an invalid
+            // size, so we'll refuse it here instead of sending an event the
+            // other side can't handle
+            if (BOOST_UNLIKELY(value < 0 || static_cast<uint64_t>(value) >
+                                                max_chunk_size)) {
+                logger.log_event(true, opcode, index, value, nullptr, option,
+                                 std::nullopt);
+                logger.log("   Warning: Refusing to send a " +
+                           std::to_string(value) +
+                           " byte chunk, the maximum chunk size is " +
+                           std::to_string(max_chunk_size) + " bytes");
+                logger.log_event_response(true, opcode, 0, nullptr,
+                                          std::nullopt);
+                return 0;
+            }
             break;
         case effCanDo: {
             const std::string query(static_cast<const char*>(data));
@@ -532,6 +616,139 @@ intptr_t PluginBridge::dispatch(AEffect* /*plugin*/,
                 return -1;
             }
         } break;
+        case effGetParamLabel:
+        case effGetParamDisplay: {
+            // Generic editors and automation lanes will query these strings
+            // for every visible parameter on every redraw. We'll cache them
+            // for the parameter's last known value, so plugins that change
+            // their parameters internally without telling the host (through
+            // MIDI, linked parameters, or internal preset loads) won't cause
+            // us to return an outdated string.
+            std::optional<float> known_value;
+            std::optional<CachedParameterString> cached_string;
+            uint64_t generation;
+            {
+                std::lock_guard lock(parameter_strings_mutex);
+                if (const auto last_value = parameter_values.find(index);
+                    last_value != parameter_values.end()) {
+                    known_value = last_value->second;
+                }
+
+                if (const auto entry =
+                        parameter_strings.find(std::pair(opcode, index));
+                    known_value && entry != parameter_strings.end() &&
+                    entry->second.value == *known_value) {
+                    cached_string = entry->second;
+                }
+
+                generation = parameter_strings_generation;
+            }
+
+            // Logging can block, so we'll do this after releasing the lock
+            if (cached_string) {
+                logger.log_event(true, opcode, index, value, WantsString{},
+                                 option, std::nullopt);
+
+                const std::string& string = cached_string->string;
+                char* output = static_cast<char*>(data);
+                std::copy(string.begin(), string.end(), output);
+                output[string.size()] = 0;
+
+                logger.log_event_response(true, opcode,
+                                          cached_string->return_value, string,
+                                          std::nullopt);
+                return cached_string->return_value;
+            }
+
+            const intptr_t return_value =
+                send_event(host_vst_dispatch, dispatch_mutex, converter,
+                           std::pair<Logger&, bool>(logger, true), opcode,
+                           index, value, data, option);
+            plugin_flight_recorder.record(
+                FlightRecorderEvent::dispatch_response, opcode, index,
+                return_value);
+
+            // We can only cache the string if we know which value it belongs
+            // to. If the cache got invalidated while we were waiting for the
+            // response, then the string we got back may already be outdated.
+            std::lock_guard lock(parameter_strings_mutex);
+            if (known_value && generation == parameter_strings_generation) {
+                parameter_strings[std::pair(opcode, index)] =
+                    CachedParameterString{
+                        .value = *known_value,
+                        .string = std::string(static_cast<const char*>(data)),
+                        .return_value = return_value};
+            }
+
+            return return_value;
+        } break;
+        case effShellGetNextPlugin: {
+            std::lock_guard lock(shell_plugins_mutex);
+
+            // If we've enumerated this shell plugin's sub-plugins before, then
+            // we can answer this ourselves without involving the Wine host
+            if (cached_shell_plugins) {
+                logger.log_event(true, opcode, index, value, WantsString{},
+                                 option, std::nullopt);
+
+                // The host will stop enumerating after we return 0, and it will
+                // start over from the first plugin the next time
+                if (next_shell_plugin >= cached_shell_plugins->size()) {
+                    next_shell_plugin = 0;
+                    logger.log_event_response(true, opcode, 0, nullptr,
+                                              std::nullopt);
+                    return 0;
+                }
+
+                // The host's buffer is only `kVstMaxProductStrLen` bytes large,
+                // and the cache file may have been edited by hand
+                const ShellPlugin& shell_plugin =
+                    (*cached_shell_plugins)[next_shell_plugin++];
+                const size_t name_length =
+                    std::min(shell_plugin.name.size(),
+                             static_cast<size_t>(kVstMaxProductStrLen - 1));
+                char* output = static_cast<char*>(data);
+                std::copy_n(shell_plugin.name.begin(), name_length, output);
+                output[name_length] = 0;
+
+                logger.log_event_response(true, opcode, shell_plugin.unique_id,
+                                          shell_plugin.name, std::nullopt);
+                return shell_plugin.unique_id;
+            }
+
+            // Otherwise we'll record the sub-plugins as the host enumerates
+            // them, and we'll store them in the cache once the shell plugin
+            // indicates that it's done
+            const intptr_t return_value =
+                send_event(host_vst_dispatch, dispatch_mutex, converter,
+                           std::pair<Logger&, bool>(logger, true), opcode,
+                           index, value, data, option);
+            plugin_flight_recorder.record(
+                FlightRecorderEvent::dispatch_response, opcode, index,
+                return_value);
+
+            if (return_value != 0) {
+                enumerated_shell_plugins.push_back(
+                    ShellPlugin{.unique_id = static_cast<int32_t>(return_value),
+                                .name = static_cast<const char*>(data)});
+            } else if (!enumerated_shell_plugins.empty()) {
+                // If the host stopped enumerating halfway through and then
+                // started over, then we'll have seen some sub-plugins twice
+                std::set<int32_t> seen_ids;
+                std::erase_if(
+                    enumerated_shell_plugins,
+                    [&](const ShellPlugin& shell_plugin) {
+                        return !seen_ids.insert(shell_plugin.unique_id).second;
+                    });
+
+                store_cached_shell_plugins(vst_plugin_path,
+                                           enumerated_shell_plugins);
+                cached_shell_plugins = std::move(enumerated_shell_plugins);
+                enumerated_shell_plugins.clear();
+            }
+
+            return return_value;
+        } break;
     }
 
     // We don't reuse any buffers here like we do for audio processing. This
@@ -539,35 +756,60 @@ intptr_t PluginBridge::dispatch(AEffect* /*plugin*/,
     // and loading plugin state it's much better to have bitsery or our
     // receiving function temporarily allocate a large enough buffer rather than
     // to have a bunch of allocated memory sitting around doing nothing.
-    return send_event(host_vst_dispatch, dispatch_mutex, converter,
-                      std::pair<Logger&, bool>(logger, true), opcode, index,
-                      value, data, option);
+    const intptr_t return_value =
+        send_event(host_vst_dispatch, dispatch_mutex, converter,
+                   std::pair<Logger&, bool>(logger, true), opcode, index, value,
+                   data, option);
+    plugin_flight_recorder.record(FlightRecorderEvent::dispatch_response,
+                                  opcode, index, return_value);
+
+    // Loading a preset or a program will change every parameter without the
+    // plugin necessarily telling the host about it
+    switch (opcode) {
+        case effSetProgram:
+        case effSetChunk:
+        case effEndSetProgram:
+        case effBeginLoadBank:
+        case effBeginLoadProgram:
+            invalidate_parameter_strings(std::nullopt);
+            break;
+    }
+
+    return return_value;
 }
 
 template <typename T>
 void PluginBridge::do_process(T** inputs, T** outputs, int sample_frames) {
-    // The inputs and outputs arrays should be `[num_inputs][sample_frames]` and
-    // `[num_outputs][sample_frames]` floats large respectfully.
-    std::vector<std::vector<T>> input_buffers(plugin.numInputs,
-                                              std::vector<T>(sample_frames));
-    for (int channel = 0; channel < plugin.numInputs; channel++) {
-        std::copy(inputs[channel], inputs[channel] + sample_frames,
-                  input_buffers[channel].begin());
-    }
-
-    const AudioBuffers request{input_buffers, sample_frames};
-    write_object(host_vst_process_replacing, request, process_buffer);
-
-    // Write the results back to the `outputs` arrays
-    const auto response =
-        read_object<AudioBuffers>(host_vst_process_replacing, process_buffer);
-    const auto& response_buffers =
-        std::get<std::vector<std::vector<T>>>(response.buffers);
+    plugin_flight_recorder.record(FlightRecorderEvent::process, 0,
+                                  sample_frames, 0);
 
-    assert(response_buffers.size() == static_cast<size_t>(plugin.numOutputs));
-    for (int channel = 0; channel < plugin.numOutputs; channel++) {
-        std::copy(response_buffers[channel].begin(),
-                  response_buffers[channel].end(), outputs[channel]);
+    // The inputs and outputs arrays should be `[num_inputs][sample_frames]` and
+    // `[num_outputs][sample_frames]` floats large respectfully. We'll send the
+    // host's input buffers as is and we'll have the response written directly
+    // to the host's output buffers, so the samples never get copied in
+    // userspace. This is also fine when the host processes in place, since
+    // all inputs have been sent before we start reading the outputs.
+    write_audio_buffers(host_vst_process_replacing, inputs, plugin.numInputs,
+                        sample_frames, process_write_buffers);
+
+    const AudioBufferHeader response =
+        read_audio_buffer_header(host_vst_process_replacing);
+    const bool has_expected_size =
+        response.sample_frames == static_cast<uint32_t>(sample_frames);
+    if (BOOST_LIKELY(has_expected_size)) {
+        read_audio_buffers(host_vst_process_replacing, response, outputs,
+                           plugin.numOutputs, process_read_buffers,
+                           process_discarded_samples);
+    } else {
+        // This should never happen, but if the Wine host sends back a
+        // different number of samples than we sent it, then writing them to
+        // the host's output buffers could overflow those buffers. We'll
+        // discard the response and output silence for this block instead.
+        read_audio_buffers(host_vst_process_replacing, response, outputs, 0,
+                           process_read_buffers, process_discarded_samples);
+        for (int channel = 0; channel < plugin.numOutputs; channel++) {
+            std::fill(outputs[channel], outputs[channel] + sample_frames, 0.0);
+        }
     }
 
     // Plugins are allowed to send MIDI events during processing using a host
@@ -583,6 +825,9 @@ void PluginBridge::do_process(T** inputs, T** outputs, int sample_frames) {
     }
 
     incoming_midi_events.clear();
+
+    plugin_flight_recorder.record(FlightRecorderEvent::process_response, 0,
+                                  sample_frames, 0);
 }
 
 void PluginBridge::process_replacing(AEffect* /*plugin*/,
@@ -596,11 +841,50 @@ void PluginBridge::process_double_replacing(AEffect* /*plugin*/,
                                             double** inputs,
                                             double** outputs,
                                             int sample_frames) {
-    do_process<double>(inputs, outputs, sample_frames);
+    if (plugin.flags & effFlagsCanDoubleReplacing) {
+        do_process<double>(inputs, outputs, sample_frames);
+        return;
+    }
+
+    // Some hosts will call `processDoubleReplacing()` even when the plugin does
+    // not advertise support for double precision audio. In that case we'll
+    // convert the audio to single precision floats and let the Wine host call
+    // `processReplacing()` instead. This also halves the amount of data we have
+    // to send over the socket. These plain conversion loops will be vectorized
+    // by the compiler.
+    conversion_input_buffers.resize(plugin.numInputs);
+    conversion_input_pointers.resize(plugin.numInputs);
+    for (int channel = 0; channel < plugin.numInputs; channel++) {
+        std::vector<float>& buffer = conversion_input_buffers[channel];
+        buffer.resize(sample_frames);
+        std::copy(inputs[channel], inputs[channel] + sample_frames,
+                  buffer.begin());
+
+        conversion_input_pointers[channel] = buffer.data();
+    }
+
+    conversion_output_buffers.resize(plugin.numOutputs);
+    conversion_output_pointers.resize(plugin.numOutputs);
+    for (int channel = 0; channel < plugin.numOutputs; channel++) {
+        std::vector<float>& buffer = conversion_output_buffers[channel];
+        buffer.resize(sample_frames);
+
+        conversion_output_pointers[channel] = buffer.data();
+    }
+
+    do_process<float>(conversion_input_pointers.data(),
+                      conversion_output_pointers.data(), sample_frames);
+
+    for (int channel = 0; channel < plugin.numOutputs; channel++) {
+        const std::vector<float>& buffer = conversion_output_buffers[channel];
+        std::copy(buffer.begin(), buffer.end(), outputs[channel]);
+    }
 }
 
 float PluginBridge::get_parameter(AEffect* /*plugin*/, int index) {
     logger.log_get_parameter(index);
+    plugin_flight_recorder.record(FlightRecorderEvent::get_parameter, 0, index,
+                                  0);
 
     const Parameter request{index, std::nullopt};
     ParameterResult response;
@@ -614,12 +898,24 @@ float PluginBridge::get_parameter(AEffect* /*plugin*/, int index) {
     }
 
     logger.log_get_parameter_response(*response.value);
+    plugin_flight_recorder.record(FlightRecorderEvent::get_parameter_response,
+                                  0, index, 0, *response.value);
+
+    // Hosts will poll this regularly, so this is how we'll notice parameter
+    // changes the plugin didn't tell the host about
+    {
+        std::lock_guard lock(parameter_strings_mutex);
+        parameter_values[index] = *response.value;
+    }
 
     return *response.value;
 }
 
 void PluginBridge::set_parameter(AEffect* /*plugin*/, int index, float value) {
     logger.log_set_parameter(index, value);
+    update_parameter_value(index, value);
+    plugin_flight_recorder.record(FlightRecorderEvent::set_parameter, 0, index,
+                                  0, value);
 
     const Parameter request{index, value};
     ParameterResult response;
@@ -632,11 +928,57 @@ void PluginBridge::set_parameter(AEffect* /*plugin*/, int index, float value) {
     }
 
     logger.log_set_parameter_response();
+    plugin_flight_recorder.record(FlightRecorderEvent::set_parameter_response,
+                                  0, index, 0);
 
     // This should not contain any values and just serve as an acknowledgement
     assert(!response.value);
 }
 
+void PluginBridge::invalidate_parameter_strings(std::optional<int> index) {
+    std::lock_guard lock(parameter_strings_mutex);
+
+    if (index) {
+        parameter_strings.erase(std::pair(effGetParamLabel, *index));
+        parameter_strings.erase(std::pair(effGetParamDisplay, *index));
+    } else {
+        parameter_strings.clear();
+    }
+
+    parameter_strings_generation++;
+}
+
+void PluginBridge::update_parameter_value(int index, float value) {
+    std::lock_guard lock(parameter_strings_mutex);
+
+    parameter_strings.erase(std::pair(effGetParamLabel, index));
+    parameter_strings.erase(std::pair(effGetParamDisplay, index));
+    parameter_values[index] = value;
+
+    parameter_strings_generation++;
+}
+
+void PluginBridge::dump_flight_recorders() {
+    // Both the host callback handler and the host guard thread can notice that
+    // the Wine host has crashed at the same time. `std::call_once()` also
+    // blocks the second caller until the dump has been written, so the host
+    // guard can't terminate the process halfway through.
+    std::call_once(flight_recorder_dump_flag, [&]() {
+        const fs::path dump_path =
+            fs::temp_directory_path() /
+            (fs::path(socket_endpoint.path()).stem().string() + "-crash.log");
+        if (write_flight_recorder_dump(dump_path, plugin_flight_recorder,
+                                       wine_flight_recorder)) {
+            logger.log(
+                "The last events before the crash have been written to '" +
+                dump_path.string() + "'.");
+        } else {
+            logger.log("Could not write the last events before the crash to '" +
+                       dump_path.string() + "'.");
+        }
+    });
+}
+
 void PluginBridge::log_init_message() {
     std::stringstream init_msg;
 
@@ -647,7 +989,11 @@ void PluginBridge::log_init_message() {
     init_msg << "plugin:       '" << vst_plugin_path.string() << "'"
              << std::endl;
     init_msg << "realtime:     '" << (has_realtime_priority ? "yes" : "no")
-             << "'" << std::endl;
+             << "'";
+    if (!has_realtime_priority) {
+        init_msg << ", run 'yabridgectl doctor' to find out why";
+    }
+    init_msg << std::endl;
     init_msg << "socket:       '" << socket_endpoint.path() << "'" << std::endl;
     init_msg << "wine prefix:  '";
 
@@ -675,6 +1021,11 @@ void PluginBridge::log_init_message() {
     init_msg << "hosting mode:  '";
     if (config.group) {
         init_msg << "plugin group \"" << *config.group << "\"";
+        if (config.group_linger) {
+            init_msg << ", lingers for " << *config.group_linger << "s";
+        } else {
+            init_msg << ", lingers forever";
+        }
     } else {
         init_msg << "individually";
     }
@@ -695,10 +1046,28 @@ void PluginBridge::log_init_message() {
         init_msg << "hack: REAPER 'audioMasterUpdateDisplay' workaround";
         other_options_set = true;
     }
+    if (!config.readahead_files.empty()) {
+        if (other_options_set) {
+            init_msg << ", ";
+        }
+        init_msg << "readahead: " << config.readahead_files.size()
+                 << " pattern(s)";
+        other_options_set = true;
+    }
     if (!other_options_set) {
         init_msg << "<none>";
     }
     init_msg << "'" << std::endl;
+    if (!config.invalid_options.empty()) {
+        init_msg << "invalid:       '";
+        for (size_t i = 0; i < config.invalid_options.size(); i++) {
+            if (i > 0) {
+                init_msg << ", ";
+            }
+            init_msg << config.invalid_options[i];
+        }
+        init_msg << "' (using the defaults instead)" << std::endl;
+    }
     init_msg << std::endl;
 
     // Include a list of enabled compile-tiem features, mostly to make debug
@@ -20,12 +20,17 @@
 
 #include <boost/asio/io_context.hpp>
 #include <boost/asio/local/stream_protocol.hpp>
+#include <atomic>
+#include <map>
 #include <mutex>
 #include <thread>
 
 #include "../common/configuration.h"
+#include "../common/flight-recorder.h"
 #include "../common/logging.h"
+#include "../common/thread-monitor.h"
 #include "host-process.h"
+#include "shell-plugin-cache.h"
 
 /**
  * This handles the communication between the Linux native VST plugin and the
@@ -74,7 +79,9 @@ class PluginBridge {
      * audio. Support for this on both the plugin and host side is pretty rare,
      * but REAPER supports it. This reuses the same infrastructure as
      * `process_replacing` is using since the host will only call one or the
-     * other.
+     * other. If the plugin does not support double precision audio, then the
+     * audio will be converted to single precision floats and processed using
+     * `processReplacing()` instead.
      */
     void process_double_replacing(AEffect* plugin,
                                   double** inputs,
@@ -97,17 +104,32 @@ class PluginBridge {
     void do_process(T** inputs, T** outputs, int sample_frames);
 
     /**
-     * The configuration for this instance of yabridge. Set based on the values
-     * from a `yabridge.toml`, if it exists.
+     * The path to the .dll being loaded in the Wine VST host.
+     */
+    const boost::filesystem::path vst_plugin_path;
+
+    /**
+     * The sub-plugins of this shell plugin from the last time the host
+     * enumerated them using `effShellGetNextPlugin()`, if this is a shell
+     * plugin and the `.dll` file hasn't changed since then. If this is set,
+     * then we'll answer `effShellGetNextPlugin()` ourselves. This is
+     * initialized before `config` so the cache file only has to be read once.
+     * Protected by `shell_plugins_mutex`.
      *
-     * @see ./utils.h:load_config_for
+     * @see load_cached_shell_plugins
      */
-    Configuration config;
+    std::optional<std::vector<ShellPlugin>> cached_shell_plugins;
 
     /**
-     * The path to the .dll being loaded in the Wine VST host.
+     * The configuration for this instance of yabridge. Set based on the values
+     * from a `yabridge.toml`, if it exists. This is initialized after
+     * `vst_plugin_path` and `cached_shell_plugins` since shell plugins may get
+     * assigned to a plugin group automatically.
+     *
+     * @see ./utils.h:load_config_for
+     * @see ./shell-plugin-cache.h:apply_shell_plugin_group
      */
-    const boost::filesystem::path vst_plugin_path;
+    Configuration config;
 
     /**
      * This AEffect struct will be populated using the data passed by the Wine
@@ -122,6 +144,46 @@ class PluginBridge {
      */
     void log_init_message();
 
+    /**
+     * Write the contents of both flight recorders to a file in the temporary
+     * directory after we detected that the Wine host crashed, and tell the user
+     * where to find it. This only does something the first time it gets
+     * called.
+     */
+    void dump_flight_recorders();
+
+    /**
+     * Remove the cached `effGetParamLabel()` and `effGetParamDisplay()`
+     * strings for a parameter, or for all parameters.
+     *
+     * @param index The index of the parameter whose value has changed, or a
+     *   nullopt if all parameters may have changed.
+     *
+     * @see parameter_strings
+     */
+    void invalidate_parameter_strings(std::optional<int> index);
+
+    /**
+     * Record a new known value for a parameter after the host has changed it
+     * through `setParameter()` or the plugin has reported a change through
+     * `audioMasterAutomate()`, and remove the strings cached for its old
+     * value.
+     *
+     * @see parameter_values
+     */
+    void update_parameter_value(int index, float value);
+
+    /**
+     * A thread that reads the plugin's `.dll` file (and any additional files
+     * configured through `Configuration::readahead_files`) into the page cache
+     * while the Wine process is starting. This has to be initialized before
+     * `vst_host`, since the whole point is to overlap this disk IO with Wine's
+     * startup.
+     *
+     * @see readahead_plugin_files
+     */
+    std::jthread plugin_readahead_handler;
+
     boost::asio::io_context io_context;
     boost::asio::local::stream_protocol::endpoint socket_endpoint;
     boost::asio::local::stream_protocol::acceptor socket_acceptor;
@@ -201,6 +263,95 @@ class PluginBridge {
      */
     const std::string wine_version;
 
+    /**
+     * Records the last few thousand events handled by this side of the bridge.
+     * This and `wine_flight_recorder` get written to a file when the Wine host
+     * crashes.
+     *
+     * @see FlightRecorder
+     */
+    FlightRecorder plugin_flight_recorder;
+    /**
+     * The flight recorder used by the Wine host. This is stored in a shared
+     * memory object we create here so we can still read it after the Wine host
+     * has crashed. This has to be initialized before the Wine host gets
+     * launched.
+     */
+    FlightRecorder wine_flight_recorder;
+    /**
+     * Makes sure the flight recorders only get dumped once, see
+     * `dump_flight_recorders()`.
+     */
+    std::once_flag flight_recorder_dump_flag;
+
+    /**
+     * Keeps track of the context switches and page faults incurred by the host
+     * callback handler thread. The host's audio thread is shared with other
+     * plugins, so we only monitor the Wine host's audio thread instead.
+     *
+     * @see ThreadMonitor
+     */
+    ThreadMonitor thread_monitor;
+
+    /**
+     * Set to true once the host calls `effClose()`. After this point the
+     * sockets will be closed, so any errors we get from them are expected
+     * rather than a sign that the Wine host crashed.
+     */
+    std::atomic_bool is_shutting_down;
+
+    /**
+     * The index in `cached_shell_plugins` of the sub-plugin we should return
+     * for the next `effShellGetNextPlugin()` call.
+     */
+    size_t next_shell_plugin = 0;
+    /**
+     * The sub-plugins the shell plugin has returned so far if
+     * `cached_shell_plugins` is not set. These will be written to the cache
+     * once the plugin returns 0 to indicate that there are no more
+     * sub-plugins.
+     */
+    std::vector<ShellPlugin> enumerated_shell_plugins;
+    std::mutex shell_plugins_mutex;
+
+    /**
+     * A cached `effGetParamLabel()` or `effGetParamDisplay()` response,
+     * together with the parameter value it was generated for.
+     */
+    struct CachedParameterString {
+        float value;
+        std::string string;
+        intptr_t return_value;
+    };
+
+    /**
+     * Cached responses for `effGetParamLabel()` and `effGetParamDisplay()`,
+     * keyed by the opcode and the parameter index. Generic editors will query
+     * these strings for every visible parameter many times per second, even
+     * when nothing has changed. A cached string is only used while the
+     * parameter's last known value in `parameter_values` still matches the
+     * value the string was generated for. On top of that, an entry gets
+     * removed when the host changes the parameter through `setParameter()`,
+     * when the plugin reports a change through `audioMasterAutomate()` or
+     * `audioMasterUpdateDisplay()`, and when a program or preset gets loaded.
+     */
+    std::map<std::pair<int, int>, CachedParameterString> parameter_strings;
+    /**
+     * The last known normalized value for every parameter, taken from the
+     * responses to `getParameter()`, from the values passed to
+     * `setParameter()`, and from the values the plugin reports through
+     * `audioMasterAutomate()`. We won't cache strings for parameters whose
+     * value we don't know yet.
+     */
+    std::map<int, float> parameter_values;
+    /**
+     * Incremented every time `parameter_strings` gets invalidated. This way we
+     * can detect that a parameter changed while we were waiting for a response
+     * from the plugin, in which case we shouldn't cache that response.
+     */
+    uint64_t parameter_strings_generation = 0;
+    std::mutex parameter_strings_mutex;
+
     /**
      * The Wine process hosting the Windows VST plugin.
      *
@@ -231,10 +382,38 @@ class PluginBridge {
     std::jthread wine_io_handler;
 
     /**
-     * A scratch buffer for sending and receiving data during `process`,
-     * `processReplacing` and `processDoubleReplacing` calls.
+     * Scratch buffers for the buffer sequences used to send and receive audio
+     * during `process`, `processReplacing` and `processDoubleReplacing` calls.
+     * These only hold pointers to the host's audio buffers.
+     *
+     * @see write_audio_buffers
+     * @see read_audio_buffers
+     */
+    std::vector<boost::asio::const_buffer> process_write_buffers;
+    std::vector<boost::asio::mutable_buffer> process_read_buffers;
+    /**
+     * Output channels the Wine host sends back that we don't have room for,
+     * or an entire response that doesn't match the host's buffer size, get
+     * read into this buffer. This is allocated up front so that never has to
+     * happen on the audio thread.
+     *
+     * @see read_audio_buffers
+     */
+    std::vector<uint8_t> process_discarded_samples =
+        std::vector<uint8_t>(max_audio_channel_size);
+
+    /**
+     * Scratch buffers for converting double precision audio to single
+     * precision audio and back when the host calls `processDoubleReplacing()`
+     * on a plugin that only supports `processReplacing()`. These are reused
+     * between calls to avoid allocations on the audio thread.
+     *
+     * @see PluginBridge::process_double_replacing
      */
-    std::vector<uint8_t> process_buffer;
+    std::vector<std::vector<float>> conversion_input_buffers;
+    std::vector<std::vector<float>> conversion_output_buffers;
+    std::vector<float*> conversion_input_pointers;
+    std::vector<float*> conversion_output_pointers;
 
     /**
      * The VST host can query a plugin for arbitrary binary data such as
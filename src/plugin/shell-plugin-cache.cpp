@@ -0,0 +1,170 @@
+// yabridge: a Wine VST bridge
+// Copyright (C) 2020  Robbert van der Helm
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#include "shell-plugin-cache.h"
+
+// See the note in `configuration.cpp`
+#define TOML_WINDOWS_COMPAT 0
+
+#include <unistd.h>
+#include <boost/process/environment.hpp>
+#include <toml++/toml.h>
+#include <cstdlib>
+#include <sstream>
+
+namespace bp = boost::process;
+namespace fs = boost::filesystem;
+
+/**
+ * Return the path to the cache file, following the XDG base directory
+ * specification.
+ */
+fs::path get_shell_plugin_cache_path() {
+    bp::environment env = boost::this_process::environment();
+
+    fs::path cache_dir;
+    if (const auto xdg_cache_home = env.find("XDG_CACHE_HOME");
+        xdg_cache_home != env.end() && !xdg_cache_home->to_string().empty()) {
+        cache_dir = xdg_cache_home->to_string();
+    } else {
+        cache_dir = fs::path(env.at("HOME").to_string()) / ".cache";
+    }
+
+    return cache_dir / "yabridge" / "shell-plugins.toml";
+}
+
+/**
+ * Read the entire cache file. Returns an empty table if the file doesn't exist
+ * or if it could not be parsed.
+ */
+toml::table read_shell_plugin_cache(const fs::path& cache_path) {
+    if (!fs::exists(cache_path)) {
+        return toml::table();
+    }
+
+    try {
+        return toml::parse_file(cache_path.string());
+    } catch (const toml::parse_error&) {
+        // A broken cache file will simply be overwritten
+        return toml::table();
+    }
+}
+
+std::optional<std::vector<ShellPlugin>> load_cached_shell_plugins(
+    const fs::path& plugin_path) {
+    try {
+        toml::table cache =
+            read_shell_plugin_cache(get_shell_plugin_cache_path());
+        const toml::table* entry = cache[plugin_path.string()].as_table();
+        if (!entry) {
+            return std::nullopt;
+        }
+
+        // The entry is only valid if the `.dll` file hasn't changed since we
+        // enumerated its sub-plugins
+        const auto mtime = (*entry)["mtime"].value<int64_t>();
+        const auto size = (*entry)["size"].value<int64_t>();
+        if (mtime != static_cast<int64_t>(fs::last_write_time(plugin_path)) ||
+            size != static_cast<int64_t>(fs::file_size(plugin_path))) {
+            return std::nullopt;
+        }
+
+        const toml::array* ids = (*entry)["ids"].as_array();
+        const toml::array* names = (*entry)["names"].as_array();
+        if (!ids || !names || ids->size() != names->size()) {
+            return std::nullopt;
+        }
+
+        std::vector<ShellPlugin> plugins;
+        for (size_t i = 0; i < ids->size(); i++) {
+            const auto unique_id = (*ids)[i].value<int64_t>();
+            const auto name = (*names)[i].value<std::string>();
+            if (!unique_id || !name) {
+                return std::nullopt;
+            }
+
+            plugins.push_back(ShellPlugin{
+                .unique_id = static_cast<int32_t>(*unique_id), .name = *name});
+        }
+
+        return plugins;
+    } catch (const fs::filesystem_error&) {
+        return std::nullopt;
+    }
+}
+
+void store_cached_shell_plugins(const fs::path& plugin_path,
+                                const std::vector<ShellPlugin>& plugins) {
+    try {
+        const fs::path cache_path = get_shell_plugin_cache_path();
+        fs::create_directories(cache_path.parent_path());
+
+        toml::array ids;
+        toml::array names;
+        for (const auto& plugin : plugins) {
+            ids.push_back(static_cast<int64_t>(plugin.unique_id));
+            names.push_back(plugin.name);
+        }
+
+        toml::table entry;
+        entry.insert_or_assign(
+            "mtime", static_cast<int64_t>(fs::last_write_time(plugin_path)));
+        entry.insert_or_assign(
+            "size", static_cast<int64_t>(fs::file_size(plugin_path)));
+        entry.insert_or_assign("ids", std::move(ids));
+        entry.insert_or_assign("names", std::move(names));
+
+        toml::table cache = read_shell_plugin_cache(cache_path);
+        cache.insert_or_assign(plugin_path.string(), std::move(entry));
+
+        // Multiple instances of yabridge may be doing this at the same time, so
+        // we'll write to a temporary file first and then atomically replace
+        // the old cache file. Those instances can also be running in the same
+        // process, so the temporary file needs a unique name.
+        std::string temporary_path = cache_path.string() + ".XXXXXX";
+        const int temporary_fd = mkstemp(temporary_path.data());
+        if (temporary_fd == -1) {
+            return;
+        }
+
+        std::ostringstream serialized_cache;
+        serialized_cache << cache << std::endl;
+        const std::string contents = serialized_cache.str();
+        const bool written =
+            write(temporary_fd, contents.data(), contents.size()) ==
+            static_cast<ssize_t>(contents.size());
+        close(temporary_fd);
+        if (!written) {
+            fs::remove(temporary_path);
+            return;
+        }
+
+        fs::rename(temporary_path, cache_path);
+    } catch (const fs::filesystem_error&) {
+        // Not being able to write the cache only means that we'll have to ask
+        // the Wine host again next time
+    }
+}
+
+Configuration apply_shell_plugin_group(Configuration config,
+                                       const fs::path& plugin_path,
+                                       bool is_shell_plugin) {
+    if (config.group_shell_plugins && !config.group && is_shell_plugin) {
+        config.group = "shell-" + plugin_path.stem().string();
+    }
+
+    return config;
+}
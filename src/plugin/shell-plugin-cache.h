@@ -0,0 +1,94 @@
+// yabridge: a Wine VST bridge
+// Copyright (C) 2020  Robbert van der Helm
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <boost/filesystem.hpp>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "../common/configuration.h"
+
+/**
+ * A single sub-plugin exposed by a shell plugin through
+ * `effShellGetNextPlugin()`.
+ */
+struct ShellPlugin {
+    /**
+     * The sub-plugin's unique ID. This is the return value of
+     * `effShellGetNextPlugin()`, and the host will pass this ID back to the
+     * plugin through `audioMasterCurrentId()` to load this sub-plugin.
+     */
+    int32_t unique_id;
+    /**
+     * The name the plugin wrote to the `data` pointer.
+     */
+    std::string name;
+};
+
+/**
+ * Shell plugins like Waves' WaveShell expose hundreds of sub-plugins, and hosts
+ * will enumerate all of them through `effShellGetNextPlugin()` every time they
+ * scan the shell. To avoid having to ask the Wine host for every single one of
+ * those, we store the results of the last complete enumeration in
+ * `$XDG_CACHE_HOME/yabridge/shell-plugins.toml`. The entries are keyed by the
+ * `.dll` file's path, and they are only considered valid as long as the
+ * `.dll` file's modification time and size have not changed. Having an entry
+ * in this cache is also how we know that a plugin is a shell plugin before
+ * launching the Wine host.
+ *
+ * @param plugin_path The path to the plugin's `.dll` file.
+ *
+ * @return The cached sub-plugins, or a nullopt if this plugin has not been
+ *   enumerated as a shell plugin before or if the `.dll` file has changed
+ *   since then.
+ */
+std::optional<std::vector<ShellPlugin>> load_cached_shell_plugins(
+    const boost::filesystem::path& plugin_path);
+
+/**
+ * Store the results of a complete `effShellGetNextPlugin()` enumeration in the
+ * cache. Failing to write to the cache is not an error, since we'll simply ask
+ * the Wine host again the next time.
+ *
+ * @param plugin_path The path to the plugin's `.dll` file.
+ * @param plugins All sub-plugins returned by the shell plugin, in order.
+ *
+ * @see load_cached_shell_plugins
+ */
+void store_cached_shell_plugins(const boost::filesystem::path& plugin_path,
+                                const std::vector<ShellPlugin>& plugins);
+
+/**
+ * If the plugin is a shell plugin we have seen before, the user has not
+ * assigned it to a plugin group, and the `group_shell_plugins` option is
+ * enabled, then assign it to a plugin group named `shell-<dll_name>`. That way
+ * all sub-plugins from the same shell get hosted in a single process, so the
+ * shell's code and data only have to be loaded once.
+ *
+ * @param config The configuration loaded for this plugin.
+ * @param plugin_path The path to the plugin's `.dll` file.
+ * @param is_shell_plugin Whether `load_cached_shell_plugins()` returned a
+ *   cached entry for this plugin. The caller already needs those cached
+ *   sub-plugins, so this way the cache file only gets read once.
+ *
+ * @return The configuration with the group set, if needed.
+ */
+Configuration apply_shell_plugin_group(
+    Configuration config,
+    const boost::filesystem::path& plugin_path,
+    bool is_shell_plugin);
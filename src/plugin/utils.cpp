@@ -16,6 +16,9 @@
 
 #include "utils.h"
 
+#include <fcntl.h>
+#include <glob.h>
+#include <unistd.h>
 #include <boost/dll/runtime_symbol_info.hpp>
 #include <boost/process/io.hpp>
 #include <boost/process/pipe.hpp>
@@ -164,28 +167,6 @@ fs::path find_vst_plugin() {
                              "VST plugin .dll file.");
 }
 
-boost::filesystem::path generate_group_endpoint(
-    const std::string& group_name,
-    const boost::filesystem::path& wine_prefix,
-    const PluginArchitecture architecture) {
-    std::ostringstream socket_name;
-    socket_name << "yabridge-group-" << group_name << "-"
-                << std::to_string(
-                       std::hash<std::string>{}(wine_prefix.string()))
-                << "-";
-    switch (architecture) {
-        case PluginArchitecture::vst_32:
-            socket_name << "x32";
-            break;
-        case PluginArchitecture::vst_64:
-            socket_name << "x64";
-            break;
-    }
-    socket_name << ".sock";
-
-    return fs::temp_directory_path() / socket_name.str();
-}
-
 fs::path generate_plugin_endpoint() {
     const auto plugin_name =
         find_vst_plugin().filename().replace_extension("").string();
@@ -281,6 +262,35 @@ Configuration load_config_for(const fs::path& yabridge_path) {
     return Configuration(*config_file, yabridge_path);
 }
 
+void readahead_plugin_files(const fs::path& plugin_path,
+                            const std::vector<std::string>& patterns) {
+    std::vector<fs::path> files{plugin_path};
+    for (const auto& pattern : patterns) {
+        glob_t matches;
+        if (glob((plugin_path.parent_path() / pattern).c_str(), 0, nullptr,
+                 &matches) == 0) {
+            for (size_t i = 0; i < matches.gl_pathc; i++) {
+                files.push_back(matches.gl_pathv[i]);
+            }
+        }
+
+        globfree(&matches);
+    }
+
+    for (const auto& file : files) {
+        // `POSIX_FADV_WILLNEED` only initiates the reads, so this doesn't block
+        // until the entire file has been read. A length of 0 means that the
+        // entire file should be read.
+        const int fd = open(file.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd == -1) {
+            continue;
+        }
+
+        posix_fadvise(fd, 0, 0, POSIX_FADV_WILLNEED);
+        close(fd);
+    }
+}
+
 bp::environment set_wineprefix() {
     bp::environment env = boost::this_process::environment();
 
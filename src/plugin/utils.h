@@ -21,6 +21,7 @@
 #include <boost/process/environment.hpp>
 
 #include "../common/configuration.h"
+#include "../common/utils.h"
 
 /**
  * Boost 1.72 was released with a known breaking bug caused by a missing
@@ -39,12 +40,6 @@ class patched_async_pipe : public boost::process::async_pipe {
     typedef typename handle_type::executor_type executor_type;
 };
 
-/**
- * A tag to differentiate between 32 and 64-bit plugins, used to determine which
- * host application to use.
- */
-enum class PluginArchitecture { vst_32, vst_64 };
-
 /**
  * Create a logger prefix based on the unique socket path for easy
  * identification. The socket path contains both the plugin's name and a unique
@@ -114,32 +109,6 @@ boost::filesystem::path find_vst_plugin();
  */
 std::optional<boost::filesystem::path> find_wineprefix();
 
-/**
- * Generate the group socket endpoint name used based on the name of the group,
- * the Wine prefix in use and the plugin architecture. The resulting format is
- * `/tmp/yabridge-group-<group_name>-<wine_prefix_id>-<architecture>.sock`. In
- * this socket name the `wine_prefix_id` is a numerical hash based on the Wine
- * prefix in use. This way the same group name can be used for multiple Wine
- * prefixes and for both 32 and 64 bit plugins without clashes.
- *
- * @param group_name The name of the plugin group.
- * @param wine_prefix The name of the Wine prefix in use. This should be
- *   obtained by first calling `set_wineprefix()` to allow the user to override
- *   this, and then falling back to `$HOME/.wine` if the environment variable is
- *   unset. Otherwise plugins run from outwide of a Wine prefix will not be
- *   groupable with those run from within `~/.wine` even though they both run
- *   under the same prefix.
- * @param architecture The architecture the plugin is using, since 64-bit
- *   processes can't host 32-bit plugins and the other way around.
- *
- * @return A socket endpoint path that corresponds to the format described
- * above.
- */
-boost::filesystem::path generate_group_endpoint(
-    const std::string& group_name,
-    const boost::filesystem::path& wine_prefix,
-    const PluginArchitecture architecture);
-
 /**
  * Generate a unique name for the Unix domain socket endpoint based on the VST
  * plugin's name. This will also generate the parent directory if it does not
@@ -189,6 +158,22 @@ std::string get_wine_version();
  */
 Configuration load_config_for(const boost::filesystem::path& yabridge_path);
 
+/**
+ * Ask the kernel to start reading the plugin's `.dll` file and any additional
+ * files matched by `patterns` into the page cache. Large plugins would
+ * otherwise spend a long time page faulting their code and resources in from
+ * disk after `LoadLibrary()`. Since we know the plugin's path long before the
+ * Wine process has started, we can overlap this disk IO with Wine's startup.
+ * This is meant to be run from a separate thread, although `posix_fadvise()`
+ * will return before the files have actually been read.
+ *
+ * @param plugin_path The path to the plugin's `.dll` file.
+ * @param patterns Glob patterns for additional files to read, relative to the
+ *   directory containing `plugin_path`. See `Configuration::readahead_files`.
+ */
+void readahead_plugin_files(const boost::filesystem::path& plugin_path,
+                            const std::vector<std::string>& patterns);
+
 /**
  * Locate the Wine prefix and set the `WINEPREFIX` environment variable if
  * found. This way it's also possible to run .dll files outside of a Wine prefix
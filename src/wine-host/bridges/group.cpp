@@ -135,8 +135,22 @@ void GroupBridge::handle_plugin_dispatch(const GroupRequest request) {
     });
 
     // Defer actually shutting down the process to allow for fast plugin
-    // scanning by allowing plugins to reuse the same group host process
-    shutdown_timer.expires_after(2s);
+    // scanning by allowing plugins to reuse the same group host process. The
+    // user can also configure the group host process to keep running
+    // indefinitely so it can be reused in a later session. In that case we'll
+    // also cancel any shutdown that was scheduled by a previous plugin.
+    std::optional<uint32_t> linger;
+    {
+        std::lock_guard lock(active_plugins_mutex);
+        linger = group_linger;
+    }
+
+    if (!linger) {
+        shutdown_timer.cancel();
+        return;
+    }
+
+    shutdown_timer.expires_after(std::chrono::seconds(*linger));
     shutdown_timer.async_wait([&](const boost::system::error_code& error) {
         // A previous timer gets canceled automatically when another plugin
         // exits
@@ -216,6 +230,18 @@ void GroupBridge::accept_requests() {
                 logger.log("Finished initializing '" + request.plugin_path +
                            "'");
 
+                // Plugins in the same group can have different linger times
+                // configured. We'll use the longest of those so the order in
+                // which plugins exit doesn't matter, and `"forever"` always
+                // wins.
+                const std::optional<uint32_t>& plugin_linger =
+                    bridge->get_config().group_linger;
+                if (!plugin_linger || !group_linger) {
+                    group_linger = std::nullopt;
+                } else {
+                    group_linger = std::max(*group_linger, *plugin_linger);
+                }
+
                 // Start listening for dispatcher events sent to the plugin's
                 // socket on another thread. The actual event handling will
                 // still occur within this IO context.
@@ -336,9 +362,9 @@ boost::asio::local::stream_protocol::acceptor create_acceptor_if_inactive(
 std::string create_logger_prefix(const fs::path& socket_path) {
     // The group socket filename will be in the format
     // '/tmp/yabridge-group-<group_name>-<wine_prefix_id>-<architecture>.sock',
-    // where Wine prefix ID is just Wine prefix ran through `std::hash` to
-    // prevent collisions without needing complicated filenames. We want to
-    // extract the group name.
+    // where Wine prefix ID is a hash of the Wine prefix's path to prevent
+    // collisions without needing complicated filenames. We want to extract the
+    // group name. See `generate_group_endpoint()` for more details.
     std::string socket_name =
         socket_path.filename().replace_extension().string();
 
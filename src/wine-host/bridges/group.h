@@ -136,15 +136,17 @@ class GroupBridge {
      * `active_plugins` map. If this causes the vector to become empty, we will
      * terminate this process. This check will be delayed by a few seconds to
      * prevent having to constantly restart the group process during plugin
-     * scanning.
+     * scanning. The exact delay is the longest `group_linger` option of all
+     * plugins hosted by this process, and the process will keep running
+     * indefinitely if any of those plugins set that option to `"forever"`.
      *
      * @param request Information about the plugin to launch, i.e. the path to
      *   the plugin and the path of the socket endpoint that will be used for
      *   communication.
      *
      * @note In the case that the process starts but no plugin gets initiated,
-     *   then the process will never exit on its own. This should not happen
-     *   though.
+     *   then the process will never exit on its own. This is what allows group
+     *   host processes to be launched ahead of time using `--group <name>`.
      */
     void handle_plugin_dispatch(const GroupRequest request);
 
@@ -286,4 +288,15 @@ class GroupBridge {
      * @see handle_plugin_dispatch
      */
     boost::asio::steady_timer shutdown_timer;
+
+    /**
+     * How long the process should keep running after the last plugin has
+     * exited. This is the maximum of the `group_linger` options of all plugins
+     * this process has hosted so far, or a nullopt if any of those plugins
+     * wants the process to keep running forever. Protected by
+     * `active_plugins_mutex`.
+     *
+     * @see handle_plugin_dispatch
+     */
+    std::optional<uint32_t> group_linger = 0;
 };
@@ -19,10 +19,20 @@
 #include <boost/asio/dispatch.hpp>
 #include <future>
 #include <iostream>
+#include <memory_resource>
 
 #include "../../common/communication.h"
 #include "../../common/events.h"
 
+using namespace std::literals::chrono_literals;
+
+/**
+ * The minimum amount of time between two batches of host callbacks sent by
+ * `Vst2Bridge::handle_deferred_host_callbacks()`. Any notifications made by the
+ * plugin during this time will be coalesced into the next batch.
+ */
+constexpr std::chrono::duration deferred_host_callbacks_interval = 1000ms / 60;
+
 /**
  * A function pointer to what should be the entry point of a VST plugin.
  */
@@ -69,8 +79,12 @@ Vst2Bridge::Vst2Bridge(boost::asio::io_context& main_context,
                        std::string plugin_dll_path,
                        std::string socket_endpoint_path)
     : io_context(main_context),
+      main_thread_id(GetCurrentThreadId()),
       plugin_handle(LoadLibrary(plugin_dll_path.c_str()), FreeLibrary),
       socket_endpoint(socket_endpoint_path),
+      flight_recorder(flight_recorder_name(socket_endpoint_path), false),
+      logger(Logger::create_for_wine_stderr()),
+      thread_monitor(logger),
       host_vst_dispatch(io_context),
       host_vst_dispatch_midi_events(io_context),
       vst_host_callback(io_context),
@@ -83,6 +97,9 @@ Vst2Bridge::Vst2Bridge(boost::asio::io_context& main_context,
                                  plugin_dll_path + "'");
     }
 
+    // The bridge is constructed on the thread that runs the Win32 message loop
+    thread_monitor.register_current_thread("GUI");
+
     // VST plugin entry point functions should be called `VSTPluginMain`, but
     // there are some older deprecated names that legacy plugins may still use
     VstEntryPoint vst_entry_point = nullptr;
@@ -110,6 +127,13 @@ Vst2Bridge::Vst2Bridge(boost::asio::io_context& main_context,
     host_vst_process_replacing.connect(socket_endpoint);
     host_vst_control.connect(socket_endpoint);
 
+    // Notifications sent from the GUI thread will be sent to the host
+    // asynchronously from this thread. This has to be started before
+    // initializing the plugin since plugins may already send these
+    // notifications during their initialization.
+    deferred_host_callbacks_handler = std::jthread(
+        [&](std::stop_token st) { handle_deferred_host_callbacks(st); });
+
     // Initialize after communication has been set up
     // We'll try to do the same `get_bridge_isntance` trick as in
     // `plugin/plugin.cpp`, but since the plugin will probably call the host
@@ -156,7 +180,13 @@ bool Vst2Bridge::should_skip_message_loop() const {
     return std::holds_alternative<EditorOpening>(editor);
 }
 
+const Configuration& Vst2Bridge::get_config() const {
+    return config;
+}
+
 void Vst2Bridge::handle_dispatch() {
+    thread_monitor.register_current_thread("dispatch");
+
     while (true) {
         try {
             receive_event(
@@ -169,11 +199,29 @@ void Vst2Bridge::handle_dispatch() {
                         // `dispatch_wrapper()`) directly, we'll run the
                         // function within the IO context so all events will be
                         // executed on the same thread as the one that runs the
-                        // Win32 message loop
-                        std::promise<intptr_t> dispatch_result;
+                        // Win32 message loop. The promise's shared state is
+                        // allocated on the stack so this doesn't have to touch
+                        // the heap for every event.
+                        std::array<std::byte, 256> dispatch_result_buffer;
+                        std::pmr::monotonic_buffer_resource
+                            dispatch_result_resource(
+                                dispatch_result_buffer.data(),
+                                dispatch_result_buffer.size());
+                        std::promise<intptr_t> dispatch_result(
+                            std::allocator_arg,
+                            std::pmr::polymorphic_allocator<intptr_t>(
+                                &dispatch_result_resource));
                         boost::asio::dispatch(io_context, [&]() {
+                            flight_recorder.record(
+                                FlightRecorderEvent::dispatch, opcode, index,
+                                value, option);
+                            main_thread_dispatch_depth++;
                             const intptr_t result = dispatch_wrapper(
                                 plugin, opcode, index, value, data, option);
+                            main_thread_dispatch_depth--;
+                            flight_recorder.record(
+                                FlightRecorderEvent::dispatch_response, opcode,
+                                index, result);
 
                             dispatch_result.set_value(result);
                         });
@@ -181,7 +229,8 @@ void Vst2Bridge::handle_dispatch() {
                         // The message loop and X11 event handling will be run
                         // separately on a timer
                         return dispatch_result.get_future().get();
-                    }));
+                    }),
+                &logger);
         } catch (const boost::system::system_error&) {
             // The plugin has cut off communications, so we can shut down this
             // host application
@@ -191,6 +240,8 @@ void Vst2Bridge::handle_dispatch() {
 }
 
 void Vst2Bridge::handle_dispatch_midi_events() {
+    thread_monitor.register_current_thread("MIDI events");
+
     while (true) {
         try {
             receive_event(
@@ -216,9 +267,15 @@ void Vst2Bridge::handle_dispatch_midi_events() {
 
                         // Exact same handling as in `passthrough_event`, apart
                         // from making a copy of the events first
+                        flight_recorder.record(
+                            FlightRecorderEvent::dispatch, event.opcode,
+                            event.index, event.value, event.option);
                         const intptr_t return_value = plugin->dispatcher(
                             plugin, event.opcode, event.index, event.value,
                             &events.as_c_events(), event.option);
+                        flight_recorder.record(
+                            FlightRecorderEvent::dispatch_response,
+                            event.opcode, event.index, return_value);
 
                         EventResult response{.return_value = return_value,
                                              .payload = nullptr,
@@ -249,6 +306,8 @@ void Vst2Bridge::handle_dispatch_midi_events() {
 }
 
 void Vst2Bridge::handle_parameters() {
+    thread_monitor.register_current_thread("parameters");
+
     while (true) {
         try {
             // Both `getParameter` and `setParameter` functions are passed
@@ -258,13 +317,23 @@ void Vst2Bridge::handle_parameters() {
             auto request = read_object<Parameter>(host_vst_parameters);
             if (request.value) {
                 // `setParameter`
+                flight_recorder.record(FlightRecorderEvent::set_parameter, 0,
+                                       request.index, 0, *request.value);
                 plugin->setParameter(plugin, request.index, *request.value);
+                flight_recorder.record(
+                    FlightRecorderEvent::set_parameter_response, 0,
+                    request.index, 0);
 
                 ParameterResult response{std::nullopt};
                 write_object(host_vst_parameters, response);
             } else {
                 // `getParameter`
+                flight_recorder.record(FlightRecorderEvent::get_parameter, 0,
+                                       request.index, 0);
                 float value = plugin->getParameter(plugin, request.index);
+                flight_recorder.record(
+                    FlightRecorderEvent::get_parameter_response, 0,
+                    request.index, 0, value);
 
                 ParameterResult response{value};
                 write_object(host_vst_parameters, response);
@@ -278,115 +347,299 @@ void Vst2Bridge::handle_parameters() {
 }
 
 void Vst2Bridge::handle_process_replacing() {
+    thread_monitor.register_current_thread("audio", true);
+
     // These are used as scratch buffers to prevent unnecessary allocations.
     // Since don't know in advance whether the host will call `processReplacing`
-    // or `processDoubleReplacing` we'll just create both.
-    std::vector<std::vector<float>> output_buffers_single_precision(
-        plugin->numOutputs);
-    std::vector<std::vector<double>> output_buffers_double_precision(
-        plugin->numOutputs);
+    // or `processDoubleReplacing` we'll just create both. The audio sent by
+    // the native plugin gets read directly into the input buffers, and the
+    // output buffers get sent back directly after processing.
+    std::vector<std::vector<float>> input_buffers_single_precision;
+    std::vector<std::vector<float>> output_buffers_single_precision;
+    std::vector<std::vector<double>> input_buffers_double_precision;
+    std::vector<std::vector<double>> output_buffers_double_precision;
+
+    // The process functions expect a `float**` or a `double**` for their inputs
+    // and their outputs
+    std::vector<float*> inputs_single_precision;
+    std::vector<float*> outputs_single_precision;
+    std::vector<double*> inputs_double_precision;
+    std::vector<double*> outputs_double_precision;
+
+    std::vector<boost::asio::const_buffer> write_buffers;
+    std::vector<boost::asio::mutable_buffer> read_buffers;
+    std::vector<uint8_t> discarded_samples(max_audio_channel_size);
+
+    // We reuse the buffers to avoid some unnecessary heap allocations, so we
+    // need to make sure the buffers are large enough since plugins can change
+    // their input and output configuration
+    const auto prepare_buffers = []<typename T>(
+                                     std::vector<std::vector<T>>& buffers,
+                                     std::vector<T*>& pointers,
+                                     size_t num_channels,
+                                     size_t sample_frames) {
+        buffers.resize(num_channels);
+        pointers.resize(num_channels);
+        for (size_t channel = 0; channel < num_channels; channel++) {
+            buffers[channel].resize(sample_frames);
+            pointers[channel] = buffers[channel].data();
+        }
+    };
 
     while (true) {
         try {
-            auto request = read_object<AudioBuffers>(host_vst_process_replacing,
-                                                     process_buffer);
+            const AudioBufferHeader request =
+                read_audio_buffer_header(host_vst_process_replacing);
+            flight_recorder.record(FlightRecorderEvent::process, 0,
+                                   request.sample_frames, 0);
+
+            // Since the host should only be calling one of `process()`,
+            // processReplacing()` or `processDoubleReplacing()`, we can all
+            // handle them over the same socket. We pick which one to call
+            // depending on the type of data we got sent and the plugin's
+            // reported support for these functions. The native plugin will
+            // only send double precision audio when the plugin has set the
+            // `effFlagsCanDoubleReplacing` flag, and it will convert the audio
+            // to single precision floats otherwise.
+            if (request.double_precision) {
+                prepare_buffers(input_buffers_double_precision,
+                                inputs_double_precision, request.num_channels,
+                                request.sample_frames);
+                read_audio_buffers(host_vst_process_replacing, request,
+                                   inputs_double_precision.data(),
+                                   request.num_channels, read_buffers,
+                                   discarded_samples);
+            } else {
+                prepare_buffers(input_buffers_single_precision,
+                                inputs_single_precision, request.num_channels,
+                                request.sample_frames);
+                read_audio_buffers(host_vst_process_replacing, request,
+                                   inputs_single_precision.data(),
+                                   request.num_channels, read_buffers,
+                                   discarded_samples);
+            }
+
             // Let the plugin process the MIDI events that were received since
             // the last buffer, and then clean up those events. This approach
             // should not be needed but Kontakt only stores pointers to rather
             // than copies of the events.
             std::lock_guard lock(next_buffer_midi_events_mutex);
 
-            // Since the host should only be calling one of `process()`,
-            // processReplacing()` or `processDoubleReplacing()`, we can all
-            // handle them over the same socket. We pick which one to call
-            // depending on the type of data we got sent and the plugin's
-            // reported support for these functions.
-            std::visit(
-                overload{
-                    [&](std::vector<std::vector<float>>& input_buffers) {
-                        // The process functions expect a `float**` for their
-                        // inputs and their outputs
-                        std::vector<float*> inputs;
-                        for (auto& buffer : input_buffers) {
-                            inputs.push_back(buffer.data());
-                        }
-
-                        // We reuse the buffers to avoid some unnecessary heap
-                        // allocations, so we need to make sure the buffers are
-                        // large enough since plugins can change their output
-                        // configuration. The type we're using here (single
-                        // precision floats vs double precisioon doubles) should
-                        // be the same as the one we're sending in our response.
-                        std::vector<float*> outputs;
-                        output_buffers_single_precision.resize(
-                            plugin->numOutputs);
-                        for (auto& buffer : output_buffers_single_precision) {
-                            buffer.resize(request.sample_frames);
-                            outputs.push_back(buffer.data());
-                        }
-
-                        // Any plugin made in the last fifteen years or so
-                        // should support `processReplacing`. In the off chance
-                        // it does not we can just emulate this behavior
-                        // ourselves.
-                        if (plugin->processReplacing) {
-                            plugin->processReplacing(plugin, inputs.data(),
-                                                     outputs.data(),
-                                                     request.sample_frames);
-                        } else {
-                            // If we zero out this buffer then the behavior is
-                            // the same as `processReplacing``
-                            for (std::vector<float>& buffer :
-                                 output_buffers_single_precision) {
-                                std::fill(buffer.begin(), buffer.end(), 0.0);
-                            }
+            if (request.double_precision) {
+                prepare_buffers(output_buffers_double_precision,
+                                outputs_double_precision, plugin->numOutputs,
+                                request.sample_frames);
 
-                            plugin->process(plugin, inputs.data(),
-                                            outputs.data(),
-                                            request.sample_frames);
-                        }
-
-                        AudioBuffers response{output_buffers_single_precision,
-                                              request.sample_frames};
-                        write_object(host_vst_process_replacing, response,
-                                     process_buffer);
-                    },
-                    [&](std::vector<std::vector<double>>& input_buffers) {
-                        // Exactly the same as the above, but for double
-                        // precision audio
-                        std::vector<double*> inputs;
-                        for (auto& buffer : input_buffers) {
-                            inputs.push_back(buffer.data());
-                        }
-
-                        std::vector<double*> outputs;
-                        output_buffers_double_precision.resize(
-                            plugin->numOutputs);
-                        for (auto& buffer : output_buffers_double_precision) {
-                            buffer.resize(request.sample_frames);
-                            outputs.push_back(buffer.data());
-                        }
-
-                        plugin->processDoubleReplacing(plugin, inputs.data(),
-                                                       outputs.data(),
-                                                       request.sample_frames);
-
-                        AudioBuffers response{output_buffers_double_precision,
-                                              request.sample_frames};
-                        write_object(host_vst_process_replacing, response,
-                                     process_buffer);
-                    }},
-                request.buffers);
+                plugin->processDoubleReplacing(
+                    plugin, inputs_double_precision.data(),
+                    outputs_double_precision.data(), request.sample_frames);
+
+                write_audio_buffers(host_vst_process_replacing,
+                                    outputs_double_precision.data(),
+                                    plugin->numOutputs, request.sample_frames,
+                                    write_buffers);
+            } else {
+                prepare_buffers(output_buffers_single_precision,
+                                outputs_single_precision, plugin->numOutputs,
+                                request.sample_frames);
+
+                // Any plugin made in the last fifteen years or so should
+                // support `processReplacing`. In the off chance it does not we
+                // can just emulate this behavior ourselves.
+                if (plugin->processReplacing) {
+                    plugin->processReplacing(
+                        plugin, inputs_single_precision.data(),
+                        outputs_single_precision.data(), request.sample_frames);
+                } else {
+                    // If we zero out this buffer then the behavior is the same
+                    // as `processReplacing``
+                    for (std::vector<float>& buffer :
+                         output_buffers_single_precision) {
+                        std::fill(buffer.begin(), buffer.end(), 0.0);
+                    }
+
+                    plugin->process(plugin, inputs_single_precision.data(),
+                                    outputs_single_precision.data(),
+                                    request.sample_frames);
+                }
+
+                write_audio_buffers(host_vst_process_replacing,
+                                    outputs_single_precision.data(),
+                                    plugin->numOutputs, request.sample_frames,
+                                    write_buffers);
+            }
 
             next_audio_buffer_midi_events.clear();
+            flight_recorder.record(FlightRecorderEvent::process_response, 0,
+                                   request.sample_frames, 0);
         } catch (const boost::system::system_error&) {
             // The plugin has cut off communications, so we can shut down this
             // host application
             break;
+        } catch (const std::runtime_error& error) {
+            // The native plugin sent us a header we can't make sense of. We
+            // can't tell where the next buffer would start at this point, so
+            // we'll close the socket. The native plugin will then handle this
+            // the same way as the Wine host crashing.
+            logger.log("Error while processing audio:");
+            logger.log(error.what());
+
+            boost::system::error_code ignored_error;
+            host_vst_process_replacing.close(ignored_error);
+            break;
+        }
+    }
+}
+
+void Vst2Bridge::handle_deferred_host_callbacks(std::stop_token st) {
+    thread_monitor.register_current_thread("deferred host callbacks");
+
+    // These notifications don't carry any payload data, so the default data
+    // converter will simply send them as is
+    DefaultDataConverter converter;
+    const auto send_callback = [&](int opcode, int index, intptr_t value,
+                                   float option) {
+        flight_recorder.record(FlightRecorderEvent::host_callback, opcode,
+                               index, value, option);
+        const intptr_t return_value =
+            send_event(vst_host_callback, host_callback_mutex, converter,
+                       std::nullopt, opcode, index, value, nullptr, option);
+        flight_recorder.record(FlightRecorderEvent::host_callback_response,
+                               opcode, index, return_value);
+    };
+
+    while (!st.stop_requested()) {
+        std::vector<DeferredHostCallback> callbacks;
+        bool update_display = false;
+        {
+            std::unique_lock lock(deferred_host_callbacks_mutex);
+            const auto has_pending_callbacks = [&]() {
+                return !deferred_host_callbacks.empty() ||
+                       update_display_pending.load(std::memory_order_acquire);
+            };
+
+            // With the REAPER workaround enabled, `audioMasterUpdateDisplay()`
+            // calls made from the audio thread only set
+            // `update_display_pending` without waking up this thread, so we'll
+            // have to check for those periodically
+            if (config.hack_reaper_update_display) {
+                deferred_host_callbacks_cv.wait_for(
+                    lock, st, deferred_host_callbacks_interval,
+                    has_pending_callbacks);
+            } else {
+                deferred_host_callbacks_cv.wait(lock, st,
+                                                has_pending_callbacks);
+            }
+            if (st.stop_requested()) {
+                break;
+            }
+            if (!has_pending_callbacks()) {
+                continue;
+            }
+
+            callbacks.swap(deferred_host_callbacks);
+            update_display = update_display_pending.exchange(
+                false, std::memory_order_acq_rel);
+        }
+
+        try {
+            for (const DeferredHostCallback& callback : callbacks) {
+                send_callback(callback.opcode, callback.index, callback.value,
+                              callback.option);
+            }
+
+            // The host only needs to know that something has changed since the
+            // last batch, so all `audioMasterUpdateDisplay()` calls made in the
+            // meantime result in a single call after the other notifications
+            if (update_display) {
+                send_callback(audioMasterUpdateDisplay, 0, 0, 0.0);
+            }
+        } catch (const boost::system::system_error&) {
+            // The plugin has cut off communications, so we can shut down this
+            // thread
+            break;
         }
+
+        // Any notifications the plugin sends in the meantime will be coalesced
+        // into the next batch
+        std::this_thread::sleep_for(deferred_host_callbacks_interval);
     }
 }
 
+bool Vst2Bridge::defer_host_callback(int opcode,
+                                     int index,
+                                     intptr_t value,
+                                     float option) {
+    switch (opcode) {
+        case audioMasterAutomate:
+        case audioMasterBeginEdit:
+        case audioMasterEndEdit:
+        case audioMasterUpdateDisplay:
+            break;
+        default:
+            return false;
+            break;
+    }
+
+    // REAPER and Renoise can freeze when the plugin calls
+    // `audioMasterUpdateDisplay()` while the host is updating the editor, so
+    // with the REAPER workaround enabled we'll always send it asynchronously
+    // regardless of which thread it came from. This may be the audio thread,
+    // so we can't lock or allocate anything here. The handler thread will
+    // periodically check this flag instead.
+    if (opcode == audioMasterUpdateDisplay &&
+        config.hack_reaper_update_display) {
+        update_display_pending.store(true, std::memory_order_release);
+        return true;
+    }
+
+    // Calls made from the audio thread should still be sent to the host right
+    // away. The same goes for calls made while the host is calling the
+    // plugin's dispatcher. The plugin may also make synchronous host callbacks
+    // like `audioMasterIOChanged()` or `audioMasterSizeWindow()` during that
+    // dispatch, and deferring the notifications would reorder them relative to
+    // those callbacks.
+    if (GetCurrentThreadId() != main_thread_id ||
+        main_thread_dispatch_depth > 0) {
+        return false;
+    }
+
+    std::lock_guard lock(deferred_host_callbacks_mutex);
+    switch (opcode) {
+        case audioMasterAutomate:
+            // If there's still an `audioMasterAutomate()` call pending for
+            // this parameter, then we'll simply update its value. We can't
+            // do this past a begin or end edit gesture for the same parameter
+            // since the host may use those to group automation.
+            for (auto callback = deferred_host_callbacks.rbegin();
+                 callback != deferred_host_callbacks.rend(); callback++) {
+                if (callback->index != index) {
+                    continue;
+                }
+
+                if (callback->opcode == audioMasterAutomate) {
+                    callback->option = option;
+                    return true;
+                } else {
+                    break;
+                }
+            }
+            break;
+        case audioMasterUpdateDisplay:
+            update_display_pending.store(true, std::memory_order_release);
+            deferred_host_callbacks_cv.notify_one();
+
+            return true;
+            break;
+    }
+
+    deferred_host_callbacks.push_back(DeferredHostCallback{
+        .opcode = opcode, .index = index, .value = value, .option = option});
+    deferred_host_callbacks_cv.notify_one();
+
+    return true;
+}
+
 intptr_t Vst2Bridge::dispatch_wrapper(AEffect* plugin,
                                       int opcode,
                                       int index,
@@ -415,13 +668,20 @@ intptr_t Vst2Bridge::dispatch_wrapper(AEffect* plugin,
             // provided by the host, and let the plugin embed itself into
             // the Wine window
             const auto x11_handle = reinterpret_cast<size_t>(data);
-            // Win32 window classes have to be unique for the whole application.
-            // When hosting multiple plugins in a group process, all plugins
-            // should get a unique window class
-            const std::string window_class =
-                "yabridge plugin " + socket_endpoint.path();
-            Editor& editor_instance = editor.emplace<Editor>(
-                config, window_class, x11_handle, plugin);
+
+            // The Wine window and its X11 connection are only created the first
+            // time the editor gets opened, and they will be reused after that
+            if (!editor_window) {
+                // Win32 window classes have to be unique for the whole
+                // application. When hosting multiple plugins in a group
+                // process, all plugins should get a unique window class
+                const std::string window_class =
+                    "yabridge plugin " + socket_endpoint.path();
+                editor_window.emplace(config, window_class);
+            }
+
+            Editor& editor_instance =
+                editor.emplace<Editor>(*editor_window, x11_handle, plugin);
 
             return plugin->dispatcher(plugin, opcode, index, value,
                                       editor_instance.get_win32_handle(),
@@ -431,7 +691,8 @@ intptr_t Vst2Bridge::dispatch_wrapper(AEffect* plugin,
             const intptr_t return_value =
                 plugin->dispatcher(plugin, opcode, index, value, data, option);
 
-            // Cleanup is handled through RAII
+            // Cleanup is handled through RAII. This only hides the Wine
+            // window, so it can be reused the next time the editor is opened.
             editor = std::monostate();
 
             return return_value;
@@ -514,7 +775,7 @@ class HostCallbackDataConverter : DefaultDataConverter {
 
     void write(const int opcode,
                void* data,
-               const EventResult& response) const override {
+               EventResult& response) const override {
         switch (opcode) {
             case audioMasterGetTime:
                 // Write the returned `VstTimeInfo` struct into a field and
@@ -570,19 +831,27 @@ intptr_t Vst2Bridge::host_callback(AEffect* effect,
                                    intptr_t value,
                                    void* data,
                                    float option) {
-    // HACK: Sadly this is needed to work around a mutual recursion issue with
-    //       REAPER and Renoise. See #29 and #32.
-    // TODO: We don't have access to the verbosity level here, but it would be
-    //       nice to log that this is being skipped when `YABRIDGE_DEBUG_LEVEL
-    //       >= 2`.
-    if (config.hack_reaper_update_display &&
-        opcode == audioMasterUpdateDisplay) {
+    // High frequency notifications coming from the GUI thread are coalesced and
+    // sent to the host asynchronously. None of these opcodes have a meaningful
+    // return value. With `hack_reaper_update_display` enabled this also covers
+    // all `audioMasterUpdateDisplay()` calls, which works around a mutual
+    // recursion issue with REAPER and Renoise. See #29 and #32. These will be
+    // added to the flight recorder when they actually get sent to the host.
+    if (defer_host_callback(opcode, index, value, option)) {
         return 0;
     }
 
+    flight_recorder.record(FlightRecorderEvent::host_callback, opcode, index,
+                           value, option);
+
     HostCallbackDataConverter converter(effect, time_info);
-    return send_event(vst_host_callback, host_callback_mutex, converter,
-                      std::nullopt, opcode, index, value, data, option);
+    const intptr_t return_value =
+        send_event(vst_host_callback, host_callback_mutex, converter,
+                   std::nullopt, opcode, index, value, data, option);
+    flight_recorder.record(FlightRecorderEvent::host_callback_response, opcode,
+                           index, return_value);
+
+    return return_value;
 }
 
 intptr_t VST_CALL_CONV host_callback_proxy(AEffect* effect,
@@ -27,10 +27,15 @@
 #include <windows.h>
 
 #include <boost/asio/local/stream_protocol.hpp>
+#include <atomic>
+#include <condition_variable>
 #include <mutex>
+#include <thread>
 
 #include "../../common/configuration.h"
+#include "../../common/flight-recorder.h"
 #include "../../common/logging.h"
+#include "../../common/thread-monitor.h"
 #include "../editor.h"
 #include "../utils.h"
 
@@ -41,6 +46,20 @@
  */
 struct EditorOpening {};
 
+/**
+ * A host callback made from the plugin's GUI thread that will be sent to the
+ * host asynchronously. Only simple notifications that don't carry a payload and
+ * whose return value is not meaningful are deferred this way.
+ *
+ * @see Vst2Bridge::defer_host_callback
+ */
+struct DeferredHostCallback {
+    int opcode;
+    int index;
+    intptr_t value;
+    float option;
+};
+
 /**
  * This hosts a Windows VST2 plugin, forwards messages sent by the Linux VST
  * plugin and provides host callback function for the plugin to talk back.
@@ -90,6 +109,13 @@ class Vst2Bridge {
      */
     bool should_skip_message_loop() const;
 
+    /**
+     * The configuration the native plugin sent us during initialization. Used
+     * by plugin groups to determine how long to keep running after the last
+     * plugin has exited.
+     */
+    const Configuration& get_config() const;
+
     /**
      * Handle events until the plugin exits. The actual events are posted to
      * `main_context` to ensure that all operations to could potentially
@@ -141,6 +167,15 @@ class Vst2Bridge {
      */
     intptr_t host_callback(AEffect*, int, int, intptr_t, void*, float);
 
+    /**
+     * Send the host callbacks queued by `defer_host_callback()` to the host.
+     * This is run on the `deferred_host_callbacks_handler` thread, and it will
+     * send at most one batch of notifications per frame so that plugins
+     * animating their GUIs can't flood the host with
+     * `audioMasterUpdateDisplay()` calls.
+     */
+    void handle_deferred_host_callbacks(std::stop_token st);
+
     /**
      * With the `audioMasterGetTime` host callback the plugin expects the return
      * value from the calblack to be a pointer to a VstTimeInfo struct. If the
@@ -150,6 +185,29 @@ class Vst2Bridge {
     std::optional<VstTimeInfo> time_info;
 
    private:
+    /**
+     * Queue a host callback instead of sending it to the host right away, if
+     * possible. Plugins will call `audioMasterAutomate()`,
+     * `audioMasterBeginEdit()`, `audioMasterEndEdit()` and
+     * `audioMasterUpdateDisplay()` at very high rates when the user is dragging
+     * a knob or when the plugin is animating its GUI. When these calls are
+     * made from the GUI thread outside of a host dispatch, we'll queue them and
+     * send them to the host asynchronously from the
+     * `deferred_host_callbacks_handler` thread. Pending `audioMasterAutomate()`
+     * calls for the same parameter are coalesced so that only the latest value
+     * gets sent, and only a single `audioMasterUpdateDisplay()` will be sent
+     * per batch. The order of the queued notifications is preserved. When
+     * `hack_reaper_update_display` is enabled, `audioMasterUpdateDisplay()`
+     * calls from any thread will be deferred without locking or allocating.
+     *
+     * @return Whether the callback has been queued. If this returns false, then
+     *   the callback should be sent to the host as usual.
+     */
+    bool defer_host_callback(int opcode,
+                             int index,
+                             intptr_t value,
+                             float option);
+
     /**
      * A wrapper around `plugin->dispatcher` that handles the opening and
      * closing of GUIs. Used inside of `handle_dispatch()`.
@@ -168,6 +226,21 @@ class Vst2Bridge {
      */
     boost::asio::io_context& io_context;
 
+    /**
+     * The ID of the thread that runs `io_context`. This is the thread the
+     * plugin has been initialized on, and the thread that handles the plugin's
+     * GUI. Used to determine whether a host callback was made from the GUI
+     * thread in `defer_host_callback()`.
+     */
+    const DWORD main_thread_id;
+
+    /**
+     * The number of host dispatches that are currently being handled on the
+     * main thread. Host callbacks made during a dispatch are never deferred in
+     * `defer_host_callback()`. Only accessed from the main thread.
+     */
+    unsigned int main_thread_dispatch_depth = 0;
+
     /**
      * The configuration for this instance of yabridge based on the `.so` file
      * that got loaded by the host. This configuration gets loaded on the plugin
@@ -194,6 +267,35 @@ class Vst2Bridge {
      */
     boost::asio::local::stream_protocol::endpoint socket_endpoint;
 
+    /**
+     * Records the last few thousand events handled by this side of the bridge.
+     * This is stored in a shared memory object created by the native plugin,
+     * so the native plugin can still write this to a file when this process
+     * crashes. This has to be opened before connecting to the sockets, since
+     * the native plugin will remove the shared memory object's name after
+     * accepting them.
+     *
+     * @see FlightRecorder
+     */
+    FlightRecorder flight_recorder;
+
+    /**
+     * Used to report this side's thread statistics. This writes to STDERR,
+     * which is captured by the native plugin or by the group host process, so
+     * anything written to this logger ends up in the regular yabridge log.
+     *
+     * @see Logger::create_for_wine_stderr
+     */
+    Logger logger;
+
+    /**
+     * Keeps track of the context switches and page faults incurred by the
+     * threads on this side of the bridge, including the Win32 message loop.
+     *
+     * @see ThreadMonitor
+     */
+    ThreadMonitor thread_monitor;
+
     // The naming convention for these sockets is `<from>_<to>_<event>`. For
     // instance the socket named `host_vst_dispatch` forwards
     // `AEffect.dispatch()` calls from the native VST host to the Windows VST
@@ -255,10 +357,33 @@ class Vst2Bridge {
     std::mutex host_callback_mutex;
 
     /**
-     * A scratch buffer for sending and receiving data during `process` and
-     * `processReplacing` calls.
+     * Host callbacks made from the GUI thread that have not yet been sent to
+     * the host.
+     *
+     * @see defer_host_callback
+     */
+    std::vector<DeferredHostCallback> deferred_host_callbacks;
+    std::mutex deferred_host_callbacks_mutex;
+    /**
+     * Set when the plugin has called `audioMasterUpdateDisplay()` since the
+     * last batch of deferred host callbacks. This is kept separate from
+     * `deferred_host_callbacks` so that it can be set from the audio thread
+     * when `hack_reaper_update_display` is enabled.
      */
-    std::vector<uint8_t> process_buffer;
+    std::atomic_bool update_display_pending = false;
+    /**
+     * Used to wake up `deferred_host_callbacks_handler` when a new callback has
+     * been queued.
+     */
+    std::condition_variable_any deferred_host_callbacks_cv;
+    /**
+     * The thread that sends the queued host callbacks to the host. This thread
+     * never calls any of the plugin's functions, so there's no need to use a
+     * `Win32Thread` here.
+     *
+     * @see handle_deferred_host_callbacks
+     */
+    std::jthread deferred_host_callbacks_handler;
 
     /**
      * The MIDI events that have been received **and processed** since the last
@@ -274,6 +399,15 @@ class Vst2Bridge {
      */
     std::mutex next_buffer_midi_events_mutex;
 
+    /**
+     * The Wine window used for the plugin's editor, along with its X11
+     * connection. This gets created the first time the host opens the editor,
+     * and it will be kept around and reused after the editor is closed since
+     * setting these up is relatively expensive. This has to be declared before
+     * `editor` since an `Editor` refers to this window.
+     */
+    std::optional<EditorWindow> editor_window;
+
     /**
      * The plugin editor window. Allows embedding the plugin's editor into a
      * Wine window, and embedding that Wine window into a window provided by the
@@ -55,10 +55,8 @@ WindowClass::~WindowClass() {
     UnregisterClass(reinterpret_cast<LPCSTR>(atom), GetModuleHandle(nullptr));
 }
 
-Editor::Editor(const Configuration& config,
-               const std::string& window_class_name,
-               const size_t parent_window_handle,
-               AEffect* effect)
+EditorWindow::EditorWindow(const Configuration& config,
+                           const std::string& window_class_name)
     : x11_connection(xcb_connect(nullptr, nullptr), xcb_disconnect),
       client_area(get_maximum_screen_dimensions(*x11_connection)),
       window_class(window_class_name),
@@ -78,7 +76,7 @@ Editor::Editor(const Configuration& config,
                                   nullptr,
                                   nullptr,
                                   GetModuleHandle(nullptr),
-                                  this),
+                                  nullptr),
                    DestroyWindow),
       win32_child_handle(
           config.editor_double_embed
@@ -98,12 +96,48 @@ Editor::Editor(const Configuration& config,
                                    nullptr),
                     DestroyWindow)
               : std::nullopt),
-      idle_timer(win32_handle.get(), idle_timer_id, 100),
+      wine_window(get_x11_handle(win32_handle.get())) {}
+
+EditorWindow::~EditorWindow() {
+    // Wine will wait for the parent window to properly delete the window during
+    // `DestroyWindow()`. `Editor` will already have reparented the window back
+    // to the root window when the editor got closed, so the window manager can
+    // handle this for us.
+    // FIXME: I have no idea why, but for some reason the window still hangs
+    //        some of the times without manually resetting the
+    //        `std::unique_ptr`` to the window handle` (which calls
+    //        `DestroyWindow()`), even though the behavior should be identical
+    //        without this line.
+    win32_child_handle.reset();
+    win32_handle.reset();
+}
+
+HWND EditorWindow::get_win32_handle() {
+    if (win32_child_handle) {
+        return win32_child_handle->get();
+    } else {
+        return win32_handle.get();
+    }
+}
+
+Editor::Editor(EditorWindow& editor_window,
+               const size_t parent_window_handle,
+               AEffect* effect)
+    : window(editor_window),
+      idle_timer(window.win32_handle.get(), idle_timer_id, 100),
       parent_window(parent_window_handle),
-      wine_window(get_x11_handle(win32_handle.get())),
-      topmost_window(find_topmost_window(*x11_connection, parent_window)),
+      topmost_window(
+          find_topmost_window(*window.x11_connection, parent_window)),
       // Needed to send update messages on a timer
       plugin(effect) {
+    xcb_connection_t* x11_connection = window.x11_connection.get();
+
+    // The window procedure needs to be able to access this object. Since the
+    // Win32 window outlives this object, we'll set this here and clear it again
+    // when the editor gets closed.
+    SetWindowLongPtr(window.win32_handle.get(), GWLP_USERDATA,
+                     reinterpret_cast<size_t>(this));
+
     // Because we're not using XEmbed Wine will interpret any local coordinates
     // as global coordinates. To work around this we'll tell the Wine window
     // it's located at its actual coordinates on screen rather than somewhere
@@ -112,55 +146,64 @@ Editor::Editor(const Configuration& config,
     // window) is moved or resized, and when the user moves his mouse over the
     // window because this is sometimes needed for plugin groups.
     const uint32_t topmost_event_mask = XCB_EVENT_MASK_STRUCTURE_NOTIFY;
-    xcb_change_window_attributes(x11_connection.get(), topmost_window,
+    xcb_change_window_attributes(x11_connection, topmost_window,
                                  XCB_CW_EVENT_MASK, &topmost_event_mask);
-    xcb_flush(x11_connection.get());
+    xcb_flush(x11_connection);
     const uint32_t parent_event_mask = XCB_EVENT_MASK_ENTER_WINDOW;
-    xcb_change_window_attributes(x11_connection.get(), parent_window,
+    xcb_change_window_attributes(x11_connection, parent_window,
                                  XCB_CW_EVENT_MASK, &parent_event_mask);
-    xcb_flush(x11_connection.get());
+    xcb_flush(x11_connection);
 
     // Embed the Win32 window into the window provided by the host. Instead of
     // using the XEmbed protocol, we'll register a few events and manage the
     // child window ourselves. This is a hack to work around the issue's
     // described in `Editor`'s docstring'.
-    xcb_reparent_window(x11_connection.get(), wine_window, parent_window, 0, 0);
-    xcb_map_window(x11_connection.get(), wine_window);
-    xcb_flush(x11_connection.get());
-
-    ShowWindow(win32_handle.get(), SW_SHOWNORMAL);
-    if (win32_child_handle) {
-        ShowWindow(win32_child_handle->get(), SW_SHOWNORMAL);
+    xcb_reparent_window(x11_connection, window.wine_window, parent_window, 0,
+                        0);
+    xcb_map_window(x11_connection, window.wine_window);
+    xcb_flush(x11_connection);
+
+    ShowWindow(window.win32_handle.get(), SW_SHOWNORMAL);
+    if (window.win32_child_handle) {
+        ShowWindow(window.win32_child_handle->get(), SW_SHOWNORMAL);
     }
 }
 
 Editor::~Editor() {
-    // Wine will wait for the parent window to properly delete the window during
-    // `DestroyWindow()`. Instead of implementing this behavior ourselves we
-    // just reparent the window back to the window root and let the WM handle
-    // it.
-    xcb_window_t root =
-        xcb_setup_roots_iterator(xcb_get_setup(x11_connection.get()))
-            .data->root;
+    xcb_connection_t* x11_connection = window.x11_connection.get();
+
+    // We'll keep the Wine window around so it can be reused for the next
+    // editor. For that we'll hide it, and then reparent it back to the root
+    // window since the host will likely destroy its own window right after
+    // this.
+    if (window.win32_child_handle) {
+        ShowWindow(window.win32_child_handle->get(), SW_HIDE);
+    }
+    ShowWindow(window.win32_handle.get(), SW_HIDE);
+    SetWindowLongPtr(window.win32_handle.get(), GWLP_USERDATA, 0);
 
-    xcb_reparent_window(x11_connection.get(), wine_window, root, 0, 0);
-    xcb_flush(x11_connection.get());
+    xcb_window_t root =
+        xcb_setup_roots_iterator(xcb_get_setup(x11_connection)).data->root;
+    xcb_reparent_window(x11_connection, window.wine_window, root, 0, 0);
+
+    // We also no longer care about the host's windows. The X11 connection will
+    // stay open, so any events that were still queued up would otherwise be
+    // handled when the next editor gets opened.
+    const uint32_t no_event_mask = XCB_EVENT_MASK_NO_EVENT;
+    xcb_change_window_attributes(x11_connection, topmost_window,
+                                 XCB_CW_EVENT_MASK, &no_event_mask);
+    xcb_change_window_attributes(x11_connection, parent_window,
+                                 XCB_CW_EVENT_MASK, &no_event_mask);
+    xcb_flush(x11_connection);
 
-    // FIXME: I have no idea why, but for some reason the window still hangs
-    //        some of the times without manually resetting the
-    //        `std::unique_ptr`` to the window handle` (which calls
-    //        `DestroyWindow()`), even though the behavior should be identical
-    //        without this line.
-    win32_child_handle.reset();
-    win32_handle.reset();
+    xcb_generic_event_t* generic_event;
+    while ((generic_event = xcb_poll_for_event(x11_connection)) != nullptr) {
+        free(generic_event);
+    }
 }
 
 HWND Editor::get_win32_handle() {
-    if (win32_child_handle) {
-        return win32_child_handle->get();
-    } else {
-        return win32_handle.get();
-    }
+    return window.get_win32_handle();
 }
 
 void Editor::send_idle_event() {
@@ -185,7 +228,7 @@ void Editor::handle_win32_events() const {
         // `effEditIdle` event sent by the host we can always filter this timer
         // event out in this event loop.
         if (msg.message == WM_TIMER && msg.wParam == idle_timer_id &&
-            msg.hwnd == win32_handle.get()) {
+            msg.hwnd == window.win32_handle.get()) {
             continue;
         }
 
@@ -199,8 +242,8 @@ void Editor::handle_x11_events() const {
     //       update while dragging while other times it does not. From all the
     //       plugins I've tested this only happens in Serum though.
     xcb_generic_event_t* generic_event;
-    while ((generic_event = xcb_poll_for_event(x11_connection.get())) !=
-           nullptr) {
+    while ((generic_event =
+                xcb_poll_for_event(window.x11_connection.get())) != nullptr) {
         switch (generic_event->response_type & event_type_mask) {
             // We're listening for `ConfigureNotify` events on the topmost
             // window before the root window, i.e. the window that's actually
@@ -232,37 +275,37 @@ void Editor::fix_local_coordinates() const {
     // window created by the plugin itself. In this case it doesn't matter that
     // the Win32 window is larger than the part of the client area the plugin
     // draws to since any excess will be clipped off by the parent window.
-    const auto query_cookie =
-        xcb_query_tree(x11_connection.get(), parent_window);
+    xcb_connection_t* x11_connection = window.x11_connection.get();
+    const auto query_cookie = xcb_query_tree(x11_connection, parent_window);
     xcb_window_t root =
-        xcb_query_tree_reply(x11_connection.get(), query_cookie, nullptr)->root;
+        xcb_query_tree_reply(x11_connection, query_cookie, nullptr)->root;
 
     // We can't directly use the `event.x` and `event.y` coordinates because the
     // parent window may also be embedded inside another window.
-    const auto translate_cookie = xcb_translate_coordinates(
-        x11_connection.get(), parent_window, root, 0, 0);
+    const auto translate_cookie =
+        xcb_translate_coordinates(x11_connection, parent_window, root, 0, 0);
     const xcb_translate_coordinates_reply_t* translated_coordinates =
-        xcb_translate_coordinates_reply(x11_connection.get(), translate_cookie,
+        xcb_translate_coordinates_reply(x11_connection, translate_cookie,
                                         nullptr);
 
     xcb_configure_notify_event_t translated_event{};
     translated_event.response_type = XCB_CONFIGURE_NOTIFY;
-    translated_event.event = wine_window;
-    translated_event.window = wine_window;
+    translated_event.event = window.wine_window;
+    translated_event.window = window.wine_window;
     // This should be set to the same sizes the window was created on. Since
     // we're not using `SetWindowPos` to resize the Window, Wine can get a bit
     // confused when we suddenly report a different client area size. Without
     // this certain plugins (such as those by Valhalla DSP) would break.
-    translated_event.width = client_area.width;
-    translated_event.height = client_area.height;
+    translated_event.width = window.client_area.width;
+    translated_event.height = window.client_area.height;
     translated_event.x = translated_coordinates->dst_x;
     translated_event.y = translated_coordinates->dst_y;
 
     xcb_send_event(
-        x11_connection.get(), false, wine_window,
+        x11_connection, false, window.wine_window,
         XCB_EVENT_MASK_STRUCTURE_NOTIFY | XCB_EVENT_MASK_SUBSTRUCTURE_NOTIFY,
         reinterpret_cast<char*>(&translated_event));
-    xcb_flush(x11_connection.get());
+    xcb_flush(x11_connection);
 }
 
 void Editor::grab_input_focus() const {
@@ -273,9 +316,9 @@ void Editor::grab_input_focus() const {
     // do this on the X11 FocusIn event, but that's not getting fired for REAPER
     // so we now do this on `WM_PARENTNOTIFY` which included every time the user
     // clicks on the Wine window.
-    xcb_set_input_focus(x11_connection.get(), XCB_INPUT_FOCUS_PARENT,
-                        wine_window, XCB_CURRENT_TIME);
-    xcb_flush(x11_connection.get());
+    xcb_set_input_focus(window.x11_connection.get(), XCB_INPUT_FOCUS_PARENT,
+                        window.wine_window, XCB_CURRENT_TIME);
+    xcb_flush(window.x11_connection.get());
 }
 
 LRESULT CALLBACK window_proc(HWND handle,
@@ -283,22 +326,6 @@ LRESULT CALLBACK window_proc(HWND handle,
                              WPARAM wParam,
                              LPARAM lParam) {
     switch (message) {
-        case WM_CREATE: {
-            const auto window_parameters =
-                reinterpret_cast<CREATESTRUCT*>(lParam);
-            const auto editor =
-                static_cast<Editor*>(window_parameters->lpCreateParams);
-            if (!editor) {
-                break;
-            }
-
-            // Sent when the window is first being created. `lParam` here
-            // contains the last argument of `CreateWindowEx`, which was a
-            // pointer to the `Editor` object. We need to attach this to the
-            // window handle so we can access our VST plugin instance later.
-            SetWindowLongPtr(handle, GWLP_USERDATA,
-                             reinterpret_cast<size_t>(editor));
-        } break;
         case WM_TIMER: {
             auto editor = reinterpret_cast<Editor*>(
                 GetWindowLongPtr(handle, GWLP_USERDATA));
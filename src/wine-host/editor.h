@@ -70,9 +70,90 @@ class WindowClass {
 };
 
 /**
- * A wrapper around the win32 windowing API to create and destroy editor
- * windows. We can embed this window into the window provided by the host, and a
- * VST plugin can then later embed itself in the window create here.
+ * The parts of an editor window that don't depend on the window provided by the
+ * host. This contains an X11 connection, a Win32 window class, and the Wine
+ * windows the plugin will embed itself in. Setting all of this up takes a
+ * while, and users tend to open and close editors all the time while mixing.
+ * So instead of destroying these when the editor gets closed, `Vst2Bridge`
+ * keeps its `EditorWindow` around and the next `Editor` will simply reparent
+ * the existing Wine window into the host's new window.
+ *
+ * @see Editor
+ */
+class EditorWindow {
+   public:
+    /**
+     * Create the Wine windows for an editor. These will be kept hidden until
+     * an `Editor` gets created for this window.
+     *
+     * @param config This instance's configuration, used to enable alternative
+     *   editor behaviours.
+     * @param window_class_name The name for the window class for editor
+     *   windows.
+     */
+    EditorWindow(const Configuration& config,
+                 const std::string& window_class_name);
+
+    ~EditorWindow();
+
+    /**
+     * Get the Win32 window handle so it can be passed to an `effEditOpen()`
+     * call. This will return the child window's handle if double editor
+     * embedding is enabled.
+     */
+    HWND get_win32_handle();
+
+    /**
+     * The X11 connection used for everything related to this window. This is
+     * kept open for as long as the window exists.
+     */
+    std::unique_ptr<xcb_connection_t, decltype(&xcb_disconnect)> x11_connection;
+
+    /**
+     * The Wine window's client area, or the maximum size of that window. This
+     * will be set to a size that's large enough to be able to enter full screen
+     * on a single display. This is more of a theoretical maximum size, as the
+     * plugin will only use a portion of this window to draw to. Because we're
+     * not changing the size of the Wine window and simply letting the user or
+     * the host resize the X11 parent window it's been embedded in instead,
+     * resizing will feel smooth and native.
+     */
+    const Size client_area;
+
+    /**
+     * The Win32 window class registered for the windows window.
+     */
+    const WindowClass window_class;
+
+    /**
+     * The handle for the window created through Wine that the plugin uses to
+     * embed itself in.
+     */
+    std::unique_ptr<std::remove_pointer_t<HWND>, decltype(&DestroyWindow)>
+        win32_handle;
+
+    /**
+     * A child window embedded inside of `win32_handle`. This is only used if
+     * the `editor_double_embed` option is enabled. It can be used as a
+     * workaround for plugins that rely on their parent window's screen
+     * coordinates instead of their own (see the 'Editor hosting modes' section
+     * of the readme for more details). The plugin should then embed itself
+     * within this child window.
+     */
+    std::optional<
+        std::unique_ptr<std::remove_pointer_t<HWND>, decltype(&DestroyWindow)>>
+        win32_child_handle;
+
+    /**
+     * The X11 window handle of the window belonging to  `win32_handle`.
+     */
+    const xcb_window_t wine_window;
+};
+
+/**
+ * A wrapper around the win32 windowing API to embed editor windows. We can
+ * embed this window into the window provided by the host, and a VST plugin can
+ * then later embed itself in the window create here.
  *
  * This was originally implemented using XEmbed. Even though that sounded like
  * the right thing to do, there were a few small issues with Wine's XEmbed
@@ -89,22 +170,20 @@ class WindowClass {
 class Editor {
    public:
     /**
-     * Open a window, embed it into the DAW's parent window and create a handle
-     * to the new Win32 window that can be used by the hosted VST plugin.
+     * Embed an editor window into the DAW's parent window and show it so it
+     * can be used by the hosted VST plugin. The window will be hidden again
+     * and reparented back to the root window when this object gets destroyed,
+     * so it can be reused for the next editor.
      *
-     * @param config This instance's configuration, used to enable alternative
-     *   editor behaviours.
-     * @param window_class_name The name for the window class for editor
-     *   windows.
+     * @param window The Wine window to embed. This should outlive this object.
      * @param parent_window_handle The X11 window handle passed by the VST host
      *   for the editor to embed itself into.
      * @param effect The plugin this window is being created for. Used to send
      *   `effEditIdle` messages on a timer.
      *
-     * @see win32_handle
+     * @see EditorWindow::get_win32_handle
      */
-    Editor(const Configuration& config,
-           const std::string& window_class_name,
+    Editor(EditorWindow& window,
            const size_t parent_window_handle,
            AEffect* effect);
 
@@ -152,47 +231,10 @@ class Editor {
 
    private:
     /**
-     * A pointer to the currently active window. Will be a null pointer if no
-     * window is active.
+     * The Wine window and X11 connection we're using for this editor.
      */
-    std::unique_ptr<xcb_connection_t, decltype(&xcb_disconnect)> x11_connection;
-
-    /**
-     * The Wine window's client area, or the maximum size of that window. This
-     * will be set to a size that's large enough to be able to enter full screen
-     * on a single display. This is more of a theoretical maximum size, as the
-     * plugin will only use a portion of this window to draw to. Because we're
-     * not changing the size of the Wine window and simply letting the user or
-     * the host resize the X11 parent window it's been embedded in instead,
-     * resizing will feel smooth and native.
-     */
-    const Size client_area;
+    EditorWindow& window;
 
-    /**
-     * The Win32 window class registered for the windows window.
-     */
-    const WindowClass window_class;
-
-    /**
-     * The handle for the window created through Wine that the plugin uses to
-     * embed itself in.
-     */
-    std::unique_ptr<std::remove_pointer_t<HWND>, decltype(&DestroyWindow)>
-        win32_handle;
-
-    /**
-     * A child window embedded inside of `win32_handle`. This is only used if
-     * the `editor_double_embed` option is enabled. It can be used as a
-     * workaround for plugins that rely on their parent window's screen
-     * coordinates instead of their own (see the 'Editor hosting modes' section
-     * of the readme for more details). The plugin should then embed itself
-     * within this child window.
-     */
-    std::optional<
-        std::unique_ptr<std::remove_pointer_t<HWND>, decltype(&DestroyWindow)>>
-        win32_child_handle;
-
-   private:
     /**
      * The Win32 API will block the `DispatchMessage` call when opening e.g. a
      * dropdown, but it will still allow timers to be run so the GUI can still
@@ -206,10 +248,6 @@ class Editor {
      * The window handle of the editor window created by the DAW.
      */
     const xcb_window_t parent_window;
-    /**
-     * The X11 window handle of the window belonging to  `win32_handle`.
-     */
-    const xcb_window_t wine_window;
     /**
      * The X11 window that's at the top of the window tree starting from
      * `parent_window`, i.e. a direct child of the root window. In most cases
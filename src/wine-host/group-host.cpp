@@ -16,6 +16,7 @@
 
 #include "boost-fix.h"
 
+#include <boost/process/environment.hpp>
 #include <iostream>
 
 // Generated inside of the build directory
@@ -44,8 +45,12 @@ int __cdecl main(int argc, char* argv[]) {
 
     // Instead of directly hosting a plugin, this process will receive a UNIX
     // domain socket endpoint path that it should listen on to allow yabridge
-    // instances to spawn plugins in this process.
-    if (argc < 2) {
+    // instances to spawn plugins in this process. Alternatively the group host
+    // can be launched ahead of time using only the group's name. In that case
+    // we'll generate the same socket endpoint path that yabridge would use for
+    // this group in the current Wine prefix.
+    const bool launch_by_name = argc >= 3 && std::string(argv[1]) == "--group";
+    if (argc < 2 || (std::string(argv[1]) == "--group" && !launch_by_name)) {
         std::cerr << "Usage: "
 #ifdef __i386__
                   << yabridge_group_host_name_32bit
@@ -53,11 +58,44 @@ int __cdecl main(int argc, char* argv[]) {
                   << yabridge_group_host_name
 #endif
                   << " <unix_domain_socket>" << std::endl;
+        std::cerr << "       "
+#ifdef __i386__
+                  << yabridge_group_host_name_32bit
+#else
+                  << yabridge_group_host_name
+#endif
+                  << " --group <group_name>" << std::endl;
 
         return 1;
     }
 
-    const std::string group_socket_endpoint_path(argv[1]);
+    std::string group_socket_endpoint_path;
+    if (launch_by_name) {
+        // This should match the logic in `GroupHost::GroupHost()`. Wine itself
+        // will also fall back to `~/.wine` when `WINEPREFIX` is not set.
+        const auto env = boost::this_process::environment();
+        boost::filesystem::path wine_prefix;
+        if (const auto wine_prefix_envvar = env.find("WINEPREFIX");
+            wine_prefix_envvar != env.end() &&
+            !wine_prefix_envvar->to_string().empty()) {
+            wine_prefix = wine_prefix_envvar->to_string();
+        } else {
+            wine_prefix =
+                boost::filesystem::path(env.at("HOME").to_string()) / ".wine";
+        }
+
+        group_socket_endpoint_path =
+            generate_group_endpoint(argv[2], wine_prefix,
+#ifdef __i386__
+                                    PluginArchitecture::vst_32
+#else
+                                    PluginArchitecture::vst_64
+#endif
+                                    )
+                .string();
+    } else {
+        group_socket_endpoint_path = argv[1];
+    }
 
     std::cerr << "Initializing yabridge group host version "
               << yabridge_git_version
@@ -65,6 +103,10 @@ int __cdecl main(int argc, char* argv[]) {
               << " (32-bit compatibility mode)"
 #endif
               << std::endl;
+    if (launch_by_name) {
+        std::cerr << "Listening on '" << group_socket_endpoint_path << "'"
+                  << std::endl;
+    }
 
     try {
         GroupBridge bridge(group_socket_endpoint_path);
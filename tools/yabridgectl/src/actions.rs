@@ -20,12 +20,14 @@ use anyhow::{Context, Result};
 use colored::Colorize;
 use std::fs;
 use std::path::{Path, PathBuf};
+use std::process::{Command, Stdio};
 
 use crate::config::{Config, InstallationMethod};
+use crate::doctor::{self, Severity};
 use crate::files;
 use crate::files::FoundFile;
 use crate::utils;
-use crate::utils::{verify_path_setup, verify_wine_setup, wrap};
+use crate::utils::{verify_path_setup, verify_wine_setup, wrap, wrap_nested};
 
 /// Add a direcotry to the plugin locations. Duplicates get ignord because we're using ordered sets.
 pub fn add_directory(config: &mut Config, path: PathBuf) -> Result<()> {
@@ -273,3 +275,100 @@ pub fn do_sync(config: &mut Config, options: &SyncOptions) -> Result<()> {
 
     Ok(())
 }
+
+/// Options passed to `yabridgectl start-group`, see `main()` for the definitions of these options.
+pub struct StartGroupOptions<'a> {
+    pub name: &'a str,
+    pub prefix: Option<PathBuf>,
+    pub use_32_bit: bool,
+}
+
+/// Launch a group host process for a plugin group ahead of time, so the first plugin using that
+/// group doesn't have to wait for Wine to start. The group host computes its own socket path from
+/// the group name, the Wine prefix and its architecture, so yabridge will connect to it just like it
+/// would to a group host it had launched itself.
+pub fn start_group(config: &Config, options: &StartGroupOptions) -> Result<()> {
+    let group_host_exe = config.yabridge_group_exe(options.use_32_bit)?;
+
+    let mut command = Command::new(&group_host_exe);
+    command
+        .arg("--group")
+        .arg(options.name)
+        .stdin(Stdio::null())
+        .stdout(Stdio::null())
+        .stderr(Stdio::null());
+    if let Some(prefix) = &options.prefix {
+        command.env("WINEPREFIX", prefix);
+    }
+
+    // We intentionally don't wait for this process, since it should keep running after yabridgectl
+    // exits
+    let group_host = command
+        .spawn()
+        .with_context(|| format!("Could not run '{}'", group_host_exe.display()))?;
+
+    println!(
+        "Started the group host process for '{}' with PID {}",
+        options.name.bright_white(),
+        group_host.id()
+    );
+    println!(
+        "{}",
+        wrap(
+            "This process will keep running until the last plugin using this group has exited, or \
+             indefinitely if those plugins have 'group_linger = \"forever\"' set in their \
+             yabridge.toml file. Set the 'YABRIDGE_DEBUG_FILE' environment variable to capture \
+             its output."
+        )
+    );
+
+    Ok(())
+}
+
+/// Check the system for common issues that increase latency or cause xruns, and explain how to fix
+/// them. See the `doctor` module for the actual checks.
+pub fn run_doctor(config: &Config) -> Result<()> {
+    let results = doctor::run_checks(config);
+
+    for result in &results {
+        let status = match result.severity {
+            Severity::Ok => "ok".green(),
+            Severity::Unknown => "unknown".bright_black(),
+            Severity::Warning => "warning".yellow(),
+            Severity::Problem => "problem".red(),
+        };
+        println!(
+            "{}",
+            wrap(&format!("[{}] {}: {}", status, result.name, result.summary))
+        );
+
+        if let Some(impact) = result.impact {
+            println!(
+                "{}",
+                wrap_nested(&format!("{} {}", "Impact:".bright_white(), impact))
+            );
+        }
+        if let Some(fix) = &result.fix {
+            println!(
+                "{}",
+                wrap_nested(&format!("{} {}", "Fix:".bright_white(), fix))
+            );
+        }
+    }
+
+    let num_issues = results
+        .iter()
+        .filter(|result| matches!(result.severity, Severity::Warning | Severity::Problem))
+        .count();
+    if num_issues == 0 {
+        println!("\nNo issues found");
+    } else {
+        println!(
+            "\nFound {} issue{}",
+            num_issues,
+            if num_issues == 1 { "" } else { "s" }
+        );
+    }
+
+    Ok(())
+}
@@ -38,6 +38,10 @@ const YABRIDGECTL_PREFIX: &str = "yabridgectl";
 const LIBYABRIDGE_NAME: &str = "libyabridge.so";
 /// The name of the script we're going to run to verify that everything's working correctly.
 const YABRIDGE_HOST_EXE_NAME: &str = "yabridge-host.exe";
+/// The name of the group host script, used to launch plugin groups ahead of time.
+const YABRIDGE_GROUP_EXE_NAME: &str = "yabridge-group.exe";
+/// The name of the 32-bit version of the group host script.
+const YABRIDGE_GROUP_32_EXE_NAME: &str = "yabridge-group-32.exe";
 /// The name of the XDG base directory prefix for yabridge's own files, relative to
 /// `$XDG_CONFIG_HOME` and `$XDG_DATA_HOME`.
 const YABRIDGE_PREFIX: &str = "yabridge";
@@ -216,6 +220,24 @@ impl Config {
         Ok(which(YABRIDGE_HOST_EXE_NAME)?)
     }
 
+    /// Return the path to `yabridge-group.exe` or `yabridge-group-32.exe`, or a descriptive error
+    /// if it can't be found. This uses the same search order as `yabridge_host_exe()`.
+    pub fn yabridge_group_exe(&self, use_32_bit: bool) -> Result<PathBuf> {
+        let exe_name = if use_32_bit {
+            YABRIDGE_GROUP_32_EXE_NAME
+        } else {
+            YABRIDGE_GROUP_EXE_NAME
+        };
+
+        let libyabridge_path = self.libyabridge()?;
+        let yabridge_group_exe_candidate = libyabridge_path.with_file_name(exe_name);
+        if yabridge_group_exe_candidate.exists() {
+            return Ok(yabridge_group_exe_candidate);
+        }
+
+        which(exe_name).with_context(|| format!("Could not find '{}'", exe_name))
+    }
+
     /// Search for VST2 plugins in all of the registered plugins directories. This will return an
     /// error if `winedump` could not be called.
     pub fn index_directories(&self) -> Result<BTreeMap<&Path, SearchResults>> {
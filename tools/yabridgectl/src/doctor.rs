@@ -0,0 +1,691 @@
+// yabridge: a Wine VST bridge
+// Copyright (C) 2020  Robbert van der Helm
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+//! The checks performed by `yabridgectl doctor`. These inspect the parts of the system that affect
+//! how reliably yabridge can process audio at low latencies. Everything here is read directly from
+//! `/proc` and `/sys`, so none of these checks need root privileges.
+
+use std::env;
+use std::fs;
+use std::os::unix::fs::MetadataExt;
+use std::path::{Path, PathBuf};
+use std::process::Command;
+
+use crate::config::Config;
+
+/// The realtime priority yabridge requests for its audio threads in `set_realtime_priority()`.
+/// `RLIMIT_RTPRIO` needs to be at least this high for that to succeed.
+const YABRIDGE_REALTIME_PRIORITY: u64 = 5;
+
+/// The amount of memory a DAW should at least be able to lock. JACK and most DAWs try to lock
+/// their entire working set with `mlockall()`, and they'll silently continue without locked memory
+/// if that fails.
+const MINIMUM_MEMLOCK_BYTES: u64 = 256 * 1024 * 1024;
+
+/// How severe the outcome of a check is.
+#[derive(Debug, Clone, Copy, PartialEq, Eq)]
+pub enum Severity {
+    /// Everything's set up correctly.
+    Ok,
+    /// We couldn't determine whether this is set up correctly, for instance because the kernel
+    /// doesn't expose the information we need.
+    Unknown,
+    /// This will cause higher latencies or more xruns, but yabridge will still work.
+    Warning,
+    /// Yabridge will not work correctly until this has been fixed.
+    Problem,
+}
+
+/// The outcome of a single check.
+pub struct CheckResult {
+    /// A short name for what's being checked.
+    pub name: &'static str,
+    pub severity: Severity,
+    /// What we found, e.g. `soft limit is 0`.
+    pub summary: String,
+    /// What this does to latency or reliability. Only set for warnings and problems.
+    pub impact: Option<&'static str>,
+    /// How to fix the issue. Only set for warnings and problems.
+    pub fix: Option<String>,
+}
+
+impl CheckResult {
+    fn ok(name: &'static str, summary: String) -> Self {
+        CheckResult {
+            name,
+            severity: Severity::Ok,
+            summary,
+            impact: None,
+            fix: None,
+        }
+    }
+
+    fn unknown(name: &'static str, summary: String) -> Self {
+        CheckResult {
+            name,
+            severity: Severity::Unknown,
+            summary,
+            impact: None,
+            fix: None,
+        }
+    }
+
+    fn issue(
+        name: &'static str,
+        severity: Severity,
+        summary: String,
+        impact: &'static str,
+        fix: String,
+    ) -> Self {
+        CheckResult {
+            name,
+            severity,
+            summary,
+            impact: Some(impact),
+            fix: Some(fix),
+        }
+    }
+}
+
+/// Run all checks, in the order they should be printed in.
+pub fn run_checks(config: &Config) -> Vec<CheckResult> {
+    let kernel = KernelInfo::read();
+
+    vec![
+        check_rtprio(),
+        check_memlock(),
+        check_cpu_governor(),
+        check_preemption(&kernel),
+        check_threaded_irqs(&kernel),
+        check_wineserver(),
+        check_wine_version(),
+        check_wine_prefix(config),
+        check_temp_dir(),
+    ]
+}
+
+/// A resource limit as reported in `/proc/self/limits`. `None` means unlimited.
+type Limit = Option<u64>;
+
+/// Read the soft limit for one of the resources from `/proc/self/limits`. These limits are
+/// inherited from the login session, so they're the same ones the DAW and yabridge will run with.
+fn read_soft_limit(resource: &str) -> Option<Limit> {
+    let limits = fs::read_to_string("/proc/self/limits").ok()?;
+    let line = limits.lines().find(|line| line.starts_with(resource))?;
+    let soft_limit = line[resource.len()..].split_whitespace().next()?;
+
+    if soft_limit == "unlimited" {
+        Some(None)
+    } else {
+        soft_limit.parse().ok().map(Some)
+    }
+}
+
+fn format_limit(limit: Limit) -> String {
+    match limit {
+        Some(value) => value.to_string(),
+        None => String::from("unlimited"),
+    }
+}
+
+/// Check whether yabridge is allowed to use `SCHED_FIFO`. Without this `set_realtime_priority()`
+/// fails and the only indication of that is `realtime: 'no'` in yabridge's initialization message.
+fn check_rtprio() -> CheckResult {
+    const NAME: &str = "realtime priority limit";
+
+    // Root can always set realtime priorities regardless of `RLIMIT_RTPRIO`
+    if read_uid() == Some(0) {
+        return CheckResult::ok(NAME, String::from("running as root"));
+    }
+
+    match read_soft_limit("Max realtime priority") {
+        None => CheckResult::unknown(NAME, String::from("could not read '/proc/self/limits'")),
+        Some(limit) if limit.map_or(true, |value| value >= YABRIDGE_REALTIME_PRIORITY) => {
+            CheckResult::ok(NAME, format!("RLIMIT_RTPRIO is {}", format_limit(limit)))
+        }
+        Some(limit) => CheckResult::issue(
+            NAME,
+            Severity::Problem,
+            format!(
+                "RLIMIT_RTPRIO is {}, yabridge needs at least {}",
+                format_limit(limit),
+                YABRIDGE_REALTIME_PRIORITY
+            ),
+            "Yabridge's audio threads and the plugin's audio threads will run with the normal \
+             scheduler, so any other process can preempt them in the middle of processing a \
+             buffer. This is the most common cause of xruns at buffer sizes below 512 samples.",
+            String::from(
+                "Add your user to the 'audio' or 'realtime' group (on Arch and Manjaro, install \
+                 'realtime-privileges'), or create '/etc/security/limits.d/audio.conf' containing \
+                 '@audio - rtprio 95'. Then log out and back in. 'chrt -f 10 whoami' should print \
+                 your username afterwards.",
+            ),
+        ),
+    }
+}
+
+/// Check whether the DAW is allowed to lock its memory.
+fn check_memlock() -> CheckResult {
+    const NAME: &str = "locked memory limit";
+
+    if read_uid() == Some(0) {
+        return CheckResult::ok(NAME, String::from("running as root"));
+    }
+
+    match read_soft_limit("Max locked memory") {
+        None => CheckResult::unknown(NAME, String::from("could not read '/proc/self/limits'")),
+        Some(limit) if limit.map_or(true, |bytes| bytes >= MINIMUM_MEMLOCK_BYTES) => {
+            CheckResult::ok(NAME, format!("RLIMIT_MEMLOCK is {}", format_limit(limit)))
+        }
+        Some(limit) => CheckResult::issue(
+            NAME,
+            Severity::Warning,
+            format!("RLIMIT_MEMLOCK is {} bytes", limit.unwrap_or_default()),
+            "JACK and most DAWs will not be able to lock their memory. When the system is low on \
+             memory, pages used by the audio thread can get swapped out and the resulting major \
+             page faults stall audio processing for several milliseconds at a time.",
+            String::from(
+                "Add '@audio - memlock unlimited' to '/etc/security/limits.d/audio.conf' (the \
+                 'realtime-privileges' package on Arch and Manjaro already does this) and make \
+                 sure your user is in the 'audio' group. Then log out and back in.",
+            ),
+        ),
+    }
+}
+
+/// Check whether all CPU cores use the `performance` frequency governor.
+fn check_cpu_governor() -> CheckResult {
+    const NAME: &str = "CPU frequency governor";
+
+    let mut governors: Vec<(String, String)> = fs::read_dir("/sys/devices/system/cpu")
+        .into_iter()
+        .flatten()
+        .filter_map(|entry| entry.ok())
+        .filter_map(|entry| {
+            let cpu = entry.file_name().to_string_lossy().into_owned();
+            if !cpu.starts_with("cpu") || !cpu[3..].chars().all(|c| c.is_ascii_digit()) {
+                return None;
+            }
+
+            let governor =
+                fs::read_to_string(entry.path().join("cpufreq/scaling_governor")).ok()?;
+            Some((cpu, governor.trim().to_owned()))
+        })
+        .collect();
+    governors.sort();
+
+    if governors.is_empty() {
+        // This is the case in most virtual machines, and when the CPU is always running at a fixed
+        // frequency
+        return CheckResult::ok(NAME, String::from("CPU frequency scaling is not enabled"));
+    }
+
+    let slow_cpus: Vec<&(String, String)> = governors
+        .iter()
+        .filter(|(_, governor)| governor != "performance")
+        .collect();
+    if slow_cpus.is_empty() {
+        return CheckResult::ok(NAME, String::from("all cores use 'performance'"));
+    }
+
+    let mut used_governors: Vec<&str> = slow_cpus
+        .iter()
+        .map(|(_, governor)| governor.as_str())
+        .collect();
+    used_governors.sort_unstable();
+    used_governors.dedup();
+
+    CheckResult::issue(
+        NAME,
+        Severity::Warning,
+        format!(
+            "{} of {} cores use '{}'",
+            slow_cpus.len(),
+            governors.len(),
+            used_governors.join("', '")
+        ),
+        "The CPU only clocks up after the load has already increased, so the first buffers after \
+         a quiet period or a sudden spike in plugin load are processed at a lower clock speed. \
+         This shows up as seemingly random xruns at small buffer sizes even though the average DSP \
+         load is low.",
+        String::from(
+            "Switch to the performance governor while producing music with 'sudo cpupower \
+             frequency-set -g performance', or set 'GOVERNOR=\"performance\"' in \
+             '/etc/default/cpupower' to make this permanent.",
+        ),
+    )
+}
+
+/// What we know about the running kernel's configuration.
+struct KernelInfo {
+    /// The kernel's build information, e.g. `#1 SMP PREEMPT_DYNAMIC Fri, 02 Oct 2020`.
+    version: String,
+    /// The kernel's command line, split on whitespace.
+    cmdline: Vec<String>,
+    /// Whether this is a `PREEMPT_RT` kernel. These force threaded IRQs and full preemption.
+    is_realtime: bool,
+}
+
+impl KernelInfo {
+    fn read() -> Self {
+        let version = fs::read_to_string("/proc/sys/kernel/version")
+            .map(|version| version.trim().to_owned())
+            .unwrap_or_default();
+        let cmdline = fs::read_to_string("/proc/cmdline")
+            .unwrap_or_default()
+            .split_whitespace()
+            .map(String::from)
+            .collect();
+        let is_realtime = fs::read_to_string("/sys/kernel/realtime")
+            .map(|contents| contents.trim() == "1")
+            .unwrap_or(false)
+            || version.split_whitespace().any(|word| word == "PREEMPT_RT");
+
+        KernelInfo {
+            version,
+            cmdline,
+            is_realtime,
+        }
+    }
+
+    /// Get the value of a `<key>=<value>` kernel parameter. The last occurrence wins, just like in
+    /// the kernel itself.
+    fn parameter(&self, key: &str) -> Option<&str> {
+        self.cmdline
+            .iter()
+            .rev()
+            .find_map(|parameter| parameter.strip_prefix(key)?.strip_prefix('='))
+    }
+}
+
+/// Check which preemption model the kernel uses.
+fn check_preemption(kernel: &KernelInfo) -> CheckResult {
+    const NAME: &str = "kernel preemption";
+    const IMPACT: &str = "Code running in the kernel cannot be interrupted until it yields, so a \
+                          realtime audio thread that becomes runnable can still have to wait for \
+                          a long system call in another process to finish. This causes latency \
+                          spikes of up to several milliseconds under disk, network or graphics \
+                          load.";
+
+    if kernel.is_realtime {
+        return CheckResult::ok(NAME, String::from("realtime kernel (PREEMPT_RT)"));
+    }
+
+    // On kernels with `PREEMPT_DYNAMIC` the actual model is chosen at boot time. Root can read the
+    // active model from debugfs, where it's shown in parentheses, e.g. `none voluntary (full)`.
+    // Otherwise we'll have to go by the kernel's command line.
+    let version_words: Vec<&str> = kernel.version.split_whitespace().collect();
+    let model = if version_words.contains(&"PREEMPT_DYNAMIC") {
+        fs::read_to_string("/sys/kernel/debug/sched/preempt")
+            .ok()
+            .and_then(|models| {
+                let start = models.find('(')?;
+                let end = models[start..].find(')')?;
+                Some(models[start + 1..start + end].to_owned())
+            })
+            .or_else(|| kernel.parameter("preempt").map(String::from))
+    } else if version_words.contains(&"PREEMPT") {
+        Some(String::from("full"))
+    } else if kernel.version.is_empty() {
+        None
+    } else {
+        Some(String::from("voluntary or none"))
+    };
+
+    match model.as_deref() {
+        Some("full") => CheckResult::ok(NAME, String::from("full preemption (PREEMPT)")),
+        Some(model) => CheckResult::issue(
+            NAME,
+            Severity::Warning,
+            format!("the kernel uses the '{}' preemption model", model),
+            IMPACT,
+            if version_words.contains(&"PREEMPT_DYNAMIC") {
+                String::from("Add 'preempt=full' to your kernel's command line and reboot.")
+            } else {
+                String::from(
+                    "Use a kernel built with 'CONFIG_PREEMPT', such as Arch's and Manjaro's \
+                     regular kernels, 'linux-zen', or a realtime kernel.",
+                )
+            },
+        ),
+        None if version_words.contains(&"PREEMPT_DYNAMIC") => CheckResult::issue(
+            NAME,
+            Severity::Unknown,
+            String::from("the preemption model is chosen at boot time and could not be read"),
+            IMPACT,
+            String::from(
+                "Add 'preempt=full' to your kernel's command line to make sure full preemption is \
+                 used, or run this command as root to check the active model.",
+            ),
+        ),
+        None => CheckResult::unknown(NAME, String::from("could not read the kernel version")),
+    }
+}
+
+/// Check whether the kernel runs interrupt handlers in threads.
+fn check_threaded_irqs(kernel: &KernelInfo) -> CheckResult {
+    const NAME: &str = "threaded IRQs";
+
+    if kernel.is_realtime {
+        CheckResult::ok(NAME, String::from("always enabled on realtime kernels"))
+    } else if kernel
+        .cmdline
+        .iter()
+        .any(|parameter| parameter == "threadirqs")
+    {
+        CheckResult::ok(NAME, String::from("enabled with 'threadirqs'"))
+    } else {
+        CheckResult::issue(
+            NAME,
+            Severity::Warning,
+            String::from("'threadirqs' is not on the kernel's command line"),
+            "Interrupt handlers for all devices run before any thread, so interrupts from your GPU, \
+             network card or disks can delay the sound card's interrupt and the audio threads \
+             waiting on it. With threaded IRQs the sound card's interrupt handler can be given a \
+             higher priority than everything else.",
+            String::from(
+                "Add 'threadirqs' to your kernel's command line and reboot. Then use 'rtirq' to \
+                 raise the priority of your sound card's IRQ thread.",
+            ),
+        )
+    }
+}
+
+/// The scheduling policy and realtime priority of a process, read from `/proc/<pid>/stat`.
+fn read_scheduling_policy(pid: &str) -> Option<(u64, u64)> {
+    let stat = fs::read_to_string(format!("/proc/{}/stat", pid)).ok()?;
+
+    // The second field is the process name in parentheses, and that name can contain spaces
+    let fields: Vec<&str> = stat[stat.rfind(')')? + 1..].split_whitespace().collect();
+
+    // These are the `rt_priority` and `policy` fields from proc(5), offset by the two fields we
+    // just skipped
+    let rt_priority = fields.get(40 - 3)?.parse().ok()?;
+    let policy = fields.get(41 - 3)?.parse().ok()?;
+
+    Some((policy, rt_priority))
+}
+
+/// Check whether the running wineserver processes run with a realtime scheduling policy.
+fn check_wineserver() -> CheckResult {
+    const NAME: &str = "wineserver priority";
+    const SCHED_FIFO: u64 = 1;
+    const SCHED_RR: u64 = 2;
+
+    let wineservers: Vec<(String, u64, u64)> = fs::read_dir("/proc")
+        .into_iter()
+        .flatten()
+        .filter_map(|entry| entry.ok())
+        .filter_map(|entry| {
+            let pid = entry.file_name().to_string_lossy().into_owned();
+            if !pid.chars().all(|c| c.is_ascii_digit()) {
+                return None;
+            }
+
+            let name = fs::read_to_string(entry.path().join("comm")).ok()?;
+            if name.trim() != "wineserver" {
+                return None;
+            }
+
+            let (policy, rt_priority) = read_scheduling_policy(&pid)?;
+            Some((pid, policy, rt_priority))
+        })
+        .collect();
+
+    if wineservers.is_empty() {
+        return CheckResult::unknown(
+            NAME,
+            String::from("wineserver is not running, load a plugin and run this again"),
+        );
+    }
+
+    let normal_priority: Vec<&str> = wineservers
+        .iter()
+        .filter(|(_, policy, _)| *policy != SCHED_FIFO && *policy != SCHED_RR)
+        .map(|(pid, _, _)| pid.as_str())
+        .collect();
+    if normal_priority.is_empty() {
+        let priorities: Vec<String> = wineservers
+            .iter()
+            .map(|(_, _, rt_priority)| rt_priority.to_string())
+            .collect();
+
+        return CheckResult::ok(NAME, format!("realtime priority {}", priorities.join(", ")));
+    }
+
+    let fsync_enabled = env::var("WINEFSYNC").map_or(false, |value| value == "1");
+    CheckResult::issue(
+        NAME,
+        Severity::Warning,
+        format!(
+            "wineserver (PID {}) uses normal scheduling",
+            normal_priority.join(", ")
+        ),
+        "Without fsync or esync, every Windows synchronization primitive a plugin uses is a \
+         round trip to wineserver. When wineserver gets preempted, the plugin's audio thread has to \
+         wait for it to be scheduled again before it can continue processing.",
+        if fsync_enabled {
+            String::from(
+                "fsync is enabled, so this mostly affects the GUI. With Wine Staging, set \
+                 'STAGING_RT_PRIORITY_SERVER=90' to have wineserver request a realtime priority.",
+            )
+        } else {
+            String::from(
+                "Use a build of Wine with fsync support and set 'WINEFSYNC=1' to bypass \
+                 wineserver entirely for synchronization, as described in yabridge's readme. With \
+                 Wine Staging you can also set 'STAGING_RT_PRIORITY_SERVER=90' to have wineserver \
+                 request a realtime priority.",
+            )
+        },
+    )
+}
+
+/// Check whether Wine can be run at all.
+fn check_wine_version() -> CheckResult {
+    const NAME: &str = "Wine version";
+
+    // These winelib scripts respect `$WINELOADER`, so we'll do the same thing
+    let wine_binary = env::var("WINELOADER").unwrap_or_else(|_| String::from("wine"));
+    match Command::new(&wine_binary).arg("--version").output() {
+        Ok(output) if output.status.success() => CheckResult::ok(
+            NAME,
+            String::from_utf8_lossy(&output.stdout).trim().to_owned(),
+        ),
+        _ => CheckResult::issue(
+            NAME,
+            Severity::Problem,
+            format!("could not run '{} --version'", wine_binary),
+            "Yabridge cannot start its Wine host processes, so no plugins can be loaded.",
+            String::from(
+                "Install Wine using your distro's package manager or the packages from WineHQ, or \
+                 point '$WINELOADER' to a working Wine binary.",
+            ),
+        ),
+    }
+}
+
+/// Read the real user ID of this process from `/proc/self/status`.
+fn read_uid() -> Option<u32> {
+    let status = fs::read_to_string("/proc/self/status").ok()?;
+    let uid_line = status.lines().find(|line| line.starts_with("Uid:"))?;
+
+    uid_line["Uid:".len()..]
+        .split_whitespace()
+        .next()?
+        .parse()
+        .ok()
+}
+
+/// Find the Wine prefix a plugin directory belongs to the same way yabridge does, by searching for
+/// the first parent directory containing a `dosdevices` directory.
+fn find_wine_prefix(directory: &Path) -> Option<PathBuf> {
+    directory
+        .ancestors()
+        .find(|candidate| candidate.join("dosdevices").is_dir())
+        .map(Path::to_path_buf)
+}
+
+/// Check whether the default Wine prefix and the prefixes containing the plugin directories
+/// managed by yabridgectl are usable.
+fn check_wine_prefix(config: &Config) -> CheckResult {
+    const NAME: &str = "Wine prefixes";
+
+    let default_prefix = env::var_os("WINEPREFIX")
+        .map(PathBuf::from)
+        .or_else(|| env::var_os("HOME").map(|home| Path::new(&home).join(".wine")));
+
+    let mut prefixes: Vec<PathBuf> = Vec::new();
+    let mut issues: Vec<String> = Vec::new();
+    if let Some(prefix) = default_prefix {
+        prefixes.push(prefix);
+    }
+    for directory in &config.plugin_dirs {
+        match find_wine_prefix(directory) {
+            Some(prefix) => prefixes.push(prefix),
+            None => issues.push(format!(
+                "'{}' is not inside of a Wine prefix",
+                directory.display()
+            )),
+        }
+    }
+    prefixes.sort();
+    prefixes.dedup();
+
+    let uid = read_uid();
+    for prefix in &prefixes {
+        match fs::metadata(prefix) {
+            Err(_) => issues.push(format!("'{}' does not exist", prefix.display())),
+            Ok(metadata) if uid.is_some() && Some(metadata.uid()) != uid => {
+                // Wine refuses to use prefixes owned by another user
+                issues.push(format!("'{}' is not owned by you", prefix.display()))
+            }
+            Ok(_) if !prefix.join("system.reg").is_file() || !prefix.join("drive_c").is_dir() => {
+                issues.push(format!(
+                    "'{}' has not been fully initialized",
+                    prefix.display()
+                ))
+            }
+            Ok(_) => (),
+        }
+    }
+
+    if issues.is_empty() {
+        CheckResult::ok(
+            NAME,
+            format!(
+                "{} prefix{} checked",
+                prefixes.len(),
+                if prefixes.len() == 1 { "" } else { "es" }
+            ),
+        )
+    } else {
+        CheckResult::issue(
+            NAME,
+            Severity::Problem,
+            issues.join(", "),
+            "Plugins outside of a Wine prefix will be run in the default prefix, where they may \
+             not find their data and license files. Wine will refuse to start in a prefix owned \
+             by another user, and it will spend several seconds recreating an incomplete prefix \
+             the first time a plugin gets loaded.",
+            String::from(
+                "Run 'wineboot' with 'WINEPREFIX' pointing to the affected prefix to initialize \
+                 it, fix its ownership with 'chown -R', and make sure plugins are installed to a \
+                 directory inside of a prefix's 'drive_c'.",
+            ),
+        )
+    }
+}
+
+/// Decode the octal escape sequences `/proc/mounts` uses for whitespace and backslashes in paths.
+fn unescape_mount_path(path: &str) -> String {
+    // The escaped bytes can be part of a multibyte UTF-8 sequence, so we can only decode the path
+    // after all escape sequences have been replaced
+    let mut result = Vec::with_capacity(path.len());
+    let mut bytes = path.bytes();
+    while let Some(byte) = bytes.next() {
+        if byte == b'\\' {
+            let escape: Vec<u8> = bytes.by_ref().take(3).collect();
+            match std::str::from_utf8(&escape)
+                .ok()
+                .and_then(|escape| u8::from_str_radix(escape, 8).ok())
+            {
+                Some(unescaped) => result.push(unescaped),
+                None => {
+                    result.push(byte);
+                    result.extend_from_slice(&escape);
+                }
+            }
+        } else {
+            result.push(byte);
+        }
+    }
+
+    String::from_utf8_lossy(&result).into_owned()
+}
+
+/// Check whether the directory yabridge creates its sockets in is backed by memory.
+fn check_temp_dir() -> CheckResult {
+    const NAME: &str = "socket directory";
+
+    // Yabridge uses `boost::filesystem::temp_directory_path()`, which also respects `$TMPDIR`
+    let temp_dir = env::temp_dir();
+    let temp_dir = temp_dir.canonicalize().unwrap_or(temp_dir);
+
+    // The most specific mount point containing the temporary directory is the one it's on
+    let filesystem = fs::read_to_string("/proc/mounts").ok().and_then(|mounts| {
+        mounts
+            .lines()
+            .filter_map(|line| {
+                let mut fields = line.split_whitespace();
+                let mount_point = unescape_mount_path(fields.nth(1)?);
+                let filesystem = fields.next()?.to_owned();
+
+                Some((PathBuf::from(mount_point), filesystem))
+            })
+            .filter(|(mount_point, _)| temp_dir.starts_with(mount_point))
+            .max_by_key(|(mount_point, _)| mount_point.as_os_str().len())
+            .map(|(_, filesystem)| filesystem)
+    });
+
+    match filesystem.as_deref() {
+        None => CheckResult::unknown(
+            NAME,
+            format!(
+                "could not determine which filesystem '{}' is on",
+                temp_dir.display()
+            ),
+        ),
+        Some("tmpfs") => CheckResult::ok(NAME, format!("'{}' is a tmpfs", temp_dir.display())),
+        Some(filesystem) => CheckResult::issue(
+            NAME,
+            Severity::Warning,
+            format!(
+                "'{}' is on a '{}' filesystem",
+                temp_dir.display(),
+                filesystem
+            ),
+            "Yabridge creates its sockets and crash logs in this directory. Data sent over the \
+             sockets never touches the disk so audio processing is not affected, but creating and \
+             removing the socket files involves filesystem metadata writes that can slow down \
+             loading plugins, especially on a busy hard drive.",
+            String::from(
+                "Mount '/tmp' as a tmpfs, for instance by enabling systemd's 'tmp.mount' unit, or \
+                 point '$TMPDIR' to a directory under '$XDG_RUNTIME_DIR' for both your DAW and \
+                 Wine.",
+            ),
+        ),
+    }
+}
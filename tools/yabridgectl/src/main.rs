@@ -23,6 +23,7 @@ use crate::config::Config;
 
 mod actions;
 mod config;
+mod doctor;
 mod files;
 mod utils;
 
@@ -58,6 +59,10 @@ fn main() -> Result<()> {
                         .required(true),
                 ),
         )
+        .subcommand(
+            App::new("doctor")
+                .about("Check the system for issues that cause xruns or higher latencies"),
+        )
         .subcommand(App::new("list").about("List the plugin install locations"))
         .subcommand(App::new("status").about("Show the installation status for all plugins"))
         .subcommand(
@@ -97,6 +102,33 @@ fn main() -> Result<()> {
                         .takes_value(true),
                 ),
         )
+        .subcommand(
+            App::new("start-group")
+                .about("Launch a plugin group's host process ahead of time")
+                .arg(
+                    Arg::with_name("name")
+                        .about("The name of the plugin group, as used in 'yabridge.toml'")
+                        .takes_value(true)
+                        .required(true),
+                )
+                .arg(
+                    Arg::with_name("prefix")
+                        .long("prefix")
+                        .about("The Wine prefix the group's plugins are installed in")
+                        .long_about(
+                            "The Wine prefix the group's plugins are installed in. If this is \
+                             not set, then the 'WINEPREFIX' environment variable or '~/.wine' \
+                             will be used, just like yabridge would.",
+                        )
+                        .validator(validate_path)
+                        .takes_value(true),
+                )
+                .arg(
+                    Arg::with_name("32-bit")
+                        .long("32-bit")
+                        .about("Launch the group host for 32-bit plugins"),
+                ),
+        )
         .subcommand(
             App::new("sync")
                 .about("Set up or update yabridge for all plugins")
@@ -139,6 +171,7 @@ fn main() -> Result<()> {
                 .value_of_t_or_exit::<PathBuf>("path")
                 .canonicalize()?,
         ),
+        ("doctor", _) => actions::run_doctor(&config),
         ("list", _) => actions::list_directories(&config),
         ("status", _) => actions::show_status(&config),
         ("set", Some(options)) => actions::set_settings(
@@ -153,6 +186,17 @@ fn main() -> Result<()> {
                     .and_then(|path| path.canonicalize().ok()),
             },
         ),
+        ("start-group", Some(options)) => actions::start_group(
+            &config,
+            &actions::StartGroupOptions {
+                name: options.value_of("name").unwrap(),
+                prefix: options
+                    .value_of_t::<PathBuf>("prefix")
+                    .ok()
+                    .and_then(|path| path.canonicalize().ok()),
+                use_32_bit: options.is_present("32-bit"),
+            },
+        ),
         ("sync", Some(options)) => actions::do_sync(
             &mut config,
             &actions::SyncOptions {
@@ -259,3 +259,13 @@ pub fn wrap(text: &str) -> String {
 
     wrapper.fill(text)
 }
+
+/// The same as [`wrap()`], but for a paragraph that belongs to the line above it. The first line
+/// gets indented with four spaces, and everything after that with eight spaces.
+pub fn wrap_nested(text: &str) -> String {
+    let wrapper = Wrapper::with_termwidth()
+        .initial_indent("    ")
+        .subsequent_indent("        ");
+
+    wrapper.fill(text)
+}